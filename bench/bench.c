@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "quantum_state.h"
+#include "quantum_gates.h"
+#include "quantum_circuit.h"
+#include "quantum_grover.h"
+#include "quantum_numa.h"
+
+#define BENCH_MAX_THREAD_COUNTS 16
+#define BENCH_SCHEMA_VERSION 1
+
+/**
+ * Benchmark driver
+ * Times every gate kernel at every target position, measurement,
+ * normalisation and whole circuits over a range of qubit counts and thread
+ * counts, and writes one JSON record per measurement. States beyond
+ * MAX_QUBITS use file-backed storage.
+ */
+typedef struct {
+    int min_qubits;
+    int max_qubits;
+    int step;
+    int thread_counts[BENCH_MAX_THREAD_COUNTS];
+    int num_thread_counts;
+    double min_time;
+    const char *output;
+} BenchOptions;
+
+typedef struct {
+    FILE *file;
+    int records;
+    int threads;
+} BenchOutput;
+
+typedef struct {
+    const char *name;
+    int num_qubits;     /* Qubits the kernel acts on */
+    double touched;     /* Fraction of amplitudes read and written */
+    void (*apply)(QuantumState *state, int target, int other);
+} BenchKernel;
+
+static void apply_x(QuantumState *s, int t, int o) { (void)o; gate_pauli_x(s, t); }
+static void apply_y(QuantumState *s, int t, int o) { (void)o; gate_pauli_y(s, t); }
+static void apply_z(QuantumState *s, int t, int o) { (void)o; gate_pauli_z(s, t); }
+static void apply_h(QuantumState *s, int t, int o) { (void)o; gate_hadamard(s, t); }
+static void apply_p(QuantumState *s, int t, int o) { (void)o; gate_phase(s, t, 0.3); }
+static void apply_rx(QuantumState *s, int t, int o) { (void)o; gate_rotation_x(s, t, 0.3); }
+static void apply_ry(QuantumState *s, int t, int o) { (void)o; gate_rotation_y(s, t, 0.3); }
+static void apply_rz(QuantumState *s, int t, int o) { (void)o; gate_rotation_z(s, t, 0.3); }
+static void apply_id(QuantumState *s, int t, int o) { (void)o; gate_identity(s, t); }
+static void apply_cnot(QuantumState *s, int t, int o) { gate_cnot(s, o, t); }
+static void apply_cz(QuantumState *s, int t, int o) { gate_cz(s, o, t); }
+static void apply_cp(QuantumState *s, int t, int o) { gate_controlled_phase(s, o, t, 0.3); }
+static void apply_swap(QuantumState *s, int t, int o) { gate_swap(s, o, t); }
+
+static void apply_u(QuantumState *s, int t, int o) {
+    static const Complex matrix[4] = {{0.6, 0.0}, {0.0, 0.8}, {0.0, 0.8}, {0.6, 0.0}};
+    (void)o;
+    gate_unitary(s, t, matrix);
+}
+
+static const BenchKernel kernels[] = {
+    {"X", 1, 1.0, apply_x}, {"Y", 1, 1.0, apply_y}, {"Z", 1, 0.5, apply_z},
+    {"H", 1, 1.0, apply_h}, {"P", 1, 0.5, apply_p}, {"RX", 1, 1.0, apply_rx},
+    {"RY", 1, 1.0, apply_ry}, {"RZ", 1, 1.0, apply_rz}, {"U", 1, 1.0, apply_u},
+    {"I", 1, 0.0, apply_id}, {"CNOT", 2, 0.5, apply_cnot}, {"CZ", 2, 0.25, apply_cz},
+    {"CP", 2, 0.25, apply_cp}, {"SWAP", 2, 0.5, apply_swap}
+};
+
+static double now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static QuantumState* bench_state(int num_qubits) {
+    QuantumState *state = num_qubits <= MAX_QUBITS ? quantum_state_create(num_qubits)
+                                                   : quantum_state_create_mapped(num_qubits, NULL);
+    if (state) quantum_state_initialise_equal_superposition(state);
+    return state;
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+/* One record per line; seconds is the mean time of one operation. Bandwidth
+ * counts a read and a write of the touched fraction of the state, and is null
+ * where that fraction is not meaningful. */
+static void emit(BenchOutput *out, const char *benchmark, const char *name, int num_qubits, int target,
+                 int repetitions, double seconds, double touched) {
+    double amplitudes = (double)((size_t)1 << num_qubits);
+
+    fprintf(out->file, "%s\n    {\"benchmark\": \"%s\", \"name\": \"%s\", \"qubits\": %d, \"target\": %d, "
+            "\"threads\": %d, \"repetitions\": %d, \"seconds\": %.9e, \"amplitudes_per_second\": %.6e, ",
+            out->records ? "," : "", benchmark, name, num_qubits, target, out->threads, repetitions, seconds,
+            amplitudes / seconds);
+    if (touched > 0.0) {
+        fprintf(out->file, "\"gigabytes_per_second\": %.4f}",
+                touched * amplitudes * sizeof(Complex) * 2.0 / seconds / 1e9);
+    } else {
+        fprintf(out->file, "\"gigabytes_per_second\": null}");
+    }
+    out->records++;
+}
+
+static void emit_header(BenchOutput *out, const BenchOptions *options) {
+    char timestamp[32];
+    time_t t = time(NULL);
+    int max_threads = 1;
+#ifdef _OPENMP
+    max_threads = omp_get_max_threads();
+#endif
+
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+    fprintf(out->file, "{\n  \"schema\": %d,\n  \"timestamp\": \"%s\",\n  \"compiler\": \"%s\",\n"
+            "  \"max_threads\": %d,\n  \"numa_nodes\": %d,\n  \"min_time\": %g,\n  \"results\": [",
+            BENCH_SCHEMA_VERSION, timestamp, __VERSION__, max_threads, quantum_numa_num_nodes(), options->min_time);
+}
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+static void bench_kernels(BenchOutput *out, const BenchOptions *options, QuantumState *state) {
+    int n = state->num_qubits;
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        if (kernels[k].num_qubits > n) continue;
+
+        for (int target = 0; target < n; target++) {
+            int other = target == 0 ? 1 : 0;
+            int repetitions = 0;
+            double start = now(), elapsed;
+
+            do {
+                kernels[k].apply(state, target, other);
+                repetitions++;
+                elapsed = now() - start;
+            } while (elapsed < options->min_time);
+
+            emit(out, "kernel", kernels[k].name, n, target, repetitions, elapsed / repetitions, kernels[k].touched);
+        }
+    }
+}
+
+static void bench_state_operations(BenchOutput *out, const BenchOptions *options, QuantumState *state) {
+    int n = state->num_qubits;
+    const char *names[] = {"measure_all", "measure_qubit", "normalise"};
+
+    for (int op = 0; op < 3; op++) {
+        int repetitions = 0;
+        double elapsed = 0.0;
+
+        /* Measurement collapses the state, so each repetition starts from a fresh superposition */
+        while (elapsed < options->min_time) {
+            quantum_state_initialise_equal_superposition(state);
+            double start = now();
+            if (op == 0) {
+                quantum_state_measure_all(state);
+            } else if (op == 1) {
+                quantum_state_measure_qubit(state, n / 2);
+            } else {
+                quantum_state_normalise(state);
+            }
+            elapsed += now() - start;
+            repetitions++;
+        }
+        emit(out, "state", names[op], n, op == 1 ? n / 2 : -1, repetitions, elapsed / repetitions, op == 2 ? 1.0 : 0.5);
+    }
+}
+
+static void run_circuit(const QuantumCircuit *circuit, QuantumState *state) {
+    for (int i = 0; i < circuit->num_gates; i++) {
+        quantum_circuit_apply_gate(&circuit->gates[i], state, NULL);
+    }
+}
+
+static void bench_circuit(BenchOutput *out, const BenchOptions *options, const char *name,
+                          const QuantumCircuit *circuit, QuantumState *state) {
+    int repetitions = 0;
+    double start = now(), elapsed;
+
+    do {
+        run_circuit(circuit, state);
+        repetitions++;
+        elapsed = now() - start;
+    } while (elapsed < options->min_time);
+
+    emit(out, "circuit", name, state->num_qubits, -1, repetitions, elapsed / repetitions, 0.0);
+}
+
+static void bench_circuits(BenchOutput *out, const BenchOptions *options, QuantumState *state) {
+    int n = state->num_qubits;
+    QuantumCircuit *circuit = quantum_circuit_create(n, "benchmark");
+    if (!circuit) return;
+
+    quantum_circuit_add_qft(circuit, 0, n - 1);
+    bench_circuit(out, options, "qft", circuit, state);
+
+    quantum_circuit_clear(circuit);
+    quantum_circuit_add_hadamard(circuit, 0);
+    for (int q = 1; q < n; q++) quantum_circuit_add_cnot(circuit, q - 1, q);
+    bench_circuit(out, options, "ghz", circuit, state);
+
+    /* Ten layers of RY on every qubit followed by a CNOT ladder */
+    srand(12345);
+    quantum_circuit_clear(circuit);
+    for (int layer = 0; layer < 10; layer++) {
+        for (int q = 0; q < n; q++) quantum_circuit_add_rotation_y(circuit, q, (rand() % 1000) / 159.0);
+        for (int q = layer % 2; q + 1 < n; q += 2) quantum_circuit_add_cnot(circuit, q, q + 1);
+    }
+    bench_circuit(out, options, "random_layers", circuit, state);
+    quantum_circuit_destroy(circuit);
+
+    /* Grover is timed per iteration; mark sets are limited to in-memory sizes */
+    if (n <= MAX_QUBITS) {
+        GroverMarkSet *marks = quantum_grover_marks_create(n);
+        if (marks) {
+            int repetitions = 0;
+            double start = now(), elapsed;
+
+            quantum_grover_marks_add(marks, (1 << n) / 3);
+            do {
+                quantum_grover_iterate(state, marks, 1);
+                repetitions++;
+                elapsed = now() - start;
+            } while (elapsed < options->min_time);
+
+            emit(out, "circuit", "grover_iteration", n, -1, repetitions, elapsed / repetitions, 0.0);
+            quantum_grover_marks_destroy(marks);
+        }
+    }
+}
+
+// =============================================================================
+// DRIVER
+// =============================================================================
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--min-qubits N] [--max-qubits N] [--step N] [--threads 1,2,4]\n"
+            "          [--min-time SECONDS] [--output FILE]\n", program);
+}
+
+static int parse_options(int argc, char *argv[], BenchOptions *options) {
+    options->min_qubits = 10;
+    options->max_qubits = MAX_QUBITS;
+    options->step = 2;
+    options->num_thread_counts = 0;
+    options->min_time = 0.02;
+    options->output = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return 0;
+
+        if (strcmp(argv[i], "--min-qubits") == 0) {
+            options->min_qubits = atoi(value);
+        } else if (strcmp(argv[i], "--max-qubits") == 0) {
+            options->max_qubits = atoi(value);
+        } else if (strcmp(argv[i], "--step") == 0) {
+            options->step = atoi(value);
+        } else if (strcmp(argv[i], "--min-time") == 0) {
+            options->min_time = atof(value);
+        } else if (strcmp(argv[i], "--output") == 0) {
+            options->output = value;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            char *p = (char *)value;
+            while (*p && options->num_thread_counts < BENCH_MAX_THREAD_COUNTS) {
+                int count = (int)strtol(p, &p, 10);
+                if (count < 1) return 0;
+                options->thread_counts[options->num_thread_counts++] = count;
+                if (*p == ',') p++;
+                else if (*p) return 0;
+            }
+        } else {
+            return 0;
+        }
+        i++;
+    }
+
+    if (options->num_thread_counts == 0) {
+        options->thread_counts[options->num_thread_counts++] = 1;
+#ifdef _OPENMP
+        if (omp_get_max_threads() > 1) options->thread_counts[options->num_thread_counts++] = omp_get_max_threads();
+#endif
+    }
+    return options->min_qubits >= 2 && options->max_qubits <= MAX_MAPPED_QUBITS &&
+           options->min_qubits <= options->max_qubits && options->step >= 1 && options->min_time > 0.0;
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    quantum_numa_initialise();
+
+    BenchOutput out;
+    out.file = options.output ? fopen(options.output, "w") : stdout;
+    out.records = 0;
+    if (!out.file) {
+        fprintf(stderr, "Error: Cannot create %s\n", options.output);
+        return 1;
+    }
+    emit_header(&out, &options);
+
+    for (int t = 0; t < options.num_thread_counts; t++) {
+        out.threads = options.thread_counts[t];
+#ifdef _OPENMP
+        omp_set_num_threads(out.threads);
+#endif
+
+        for (int n = options.min_qubits; n <= options.max_qubits; n += options.step) {
+            fprintf(stderr, "Benchmarking %d qubits on %d thread(s)\n", n, out.threads);
+            QuantumState *state = bench_state(n);
+            if (!state) continue;
+
+            bench_kernels(&out, &options, state);
+            bench_state_operations(&out, &options, state);
+            bench_circuits(&out, &options, state);
+            quantum_state_destroy(state);
+        }
+    }
+
+    fprintf(out.file, "\n  ]\n}\n");
+    if (out.file != stdout) fclose(out.file);
+    return 0;
+}
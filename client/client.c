@@ -0,0 +1,248 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+#include "quantum_utils.h"
+#include "quantum_service.h"
+#include "quantum_profile.h"
+
+#define CLIENT_MAX_TERMS 256
+
+/**
+ * Command-line client for the simulator service
+ * Sends one circuit file (OpenQASM text or a binary circuit file) to a
+ * service started with `quantum_simulator --serve SOCKET` and prints the
+ * counts, expectation values or state it returns. --repeat sends the same
+ * job several times over one connection and reports the per-job latency.
+ */
+typedef struct {
+    const char *socket_path;
+    const char *circuit_path;
+    ServiceResult result;
+    unsigned int shots;
+    PauliTerm terms[CLIENT_MAX_TERMS];
+    int num_terms;
+    double parameters[MAX_PARAMETERS];
+    int num_parameters;
+    int repeat;
+} ClientOptions;
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s SOCKET CIRCUIT [--shots N | --expect TERMS | --state]\n"
+            "          [--parameters V1,V2,...] [--repeat N]\n"
+            "       %s SOCKET --shutdown\n"
+            "TERMS is a comma-separated list of [COEFFICIENT*]PAULIS such as 0.5*XXI,ZZZ;\n"
+            "the last letter acts on qubit 0.\n", program, program);
+}
+
+/* "0.5*XZI" → x/z masks with the rightmost letter on qubit 0 */
+static int parse_term(const char *text, size_t length, PauliTerm *term) {
+    const char *star = memchr(text, '*', length);
+    term->coefficient = 1.0;
+    term->x_mask = 0;
+    term->z_mask = 0;
+
+    if (star) {
+        char *end;
+        term->coefficient = strtod(text, &end);
+        if (end != star) return 0;
+        length -= (size_t)(star + 1 - text);
+        text = star + 1;
+    }
+    if (length == 0 || length > 32) return 0;
+
+    for (size_t k = 0; k < length; k++) {
+        uint32_t bit = 1u << (length - 1 - k);
+        switch (text[k]) {
+            case 'I': break;
+            case 'X': term->x_mask |= bit; break;
+            case 'Y': term->x_mask |= bit; term->z_mask |= bit; break;
+            case 'Z': term->z_mask |= bit; break;
+            default: return 0;
+        }
+    }
+    return 1;
+}
+
+static int parse_options(int argc, char *argv[], ClientOptions *options) {
+    memset(options, 0, sizeof(*options));
+    options->result = SERVICE_RESULT_COUNTS;
+    options->shots = 1024;
+    options->repeat = 1;
+
+    if (argc < 3) return 0;
+    options->socket_path = argv[1];
+    if (strcmp(argv[2], "--shutdown") == 0) {
+        options->result = SERVICE_RESULT_SHUTDOWN;
+        return argc == 3;
+    }
+    options->circuit_path = argv[2];
+
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--state") == 0) {
+            options->result = SERVICE_RESULT_STATE;
+            continue;
+        }
+        const char *value = i + 1 < argc ? argv[++i] : NULL;
+        if (!value) return 0;
+
+        if (strcmp(argv[i - 1], "--shots") == 0) {
+            options->result = SERVICE_RESULT_COUNTS;
+            options->shots = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(argv[i - 1], "--repeat") == 0) {
+            options->repeat = atoi(value);
+            if (options->repeat < 1) return 0;
+        } else if (strcmp(argv[i - 1], "--expect") == 0) {
+            options->result = SERVICE_RESULT_EXPECTATION;
+            for (const char *p = value; *p; ) {
+                size_t length = strcspn(p, ",");
+                if (options->num_terms == CLIENT_MAX_TERMS ||
+                    !parse_term(p, length, &options->terms[options->num_terms++])) {
+                    fprintf(stderr, "Error: Cannot parse Pauli term '%.*s'\n", (int)length, p);
+                    return 0;
+                }
+                p += length + (p[length] == ',');
+            }
+        } else if (strcmp(argv[i - 1], "--parameters") == 0) {
+            char *p = (char *)value;
+            while (*p && options->num_parameters < MAX_PARAMETERS) {
+                options->parameters[options->num_parameters++] = strtod(p, &p);
+                if (*p == ',') p++;
+                else if (*p) return 0;
+            }
+        } else {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static char* read_file(const char *path, size_t *length) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open %s\n", path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *data = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (!data || fread(data, 1, (size_t)size, file) != (size_t)size) {
+        fprintf(stderr, "Error: Cannot read %s\n", path);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    *length = (size_t)size;
+    return data;
+}
+
+static int compare_hits(const void *a, const void *b) {
+    const ServiceCount *x = a, *y = b;
+    if (x->hits != y->hits) return x->hits < y->hits ? 1 : -1;
+    return x->outcome < y->outcome ? -1 : (x->outcome > y->outcome);
+}
+
+static void print_result(const ClientOptions *options, const ServiceResponse *response, void *payload) {
+    int n = (int)response->num_qubits;
+
+    if (options->result == SERVICE_RESULT_COUNTS) {
+        ServiceCount *counts = payload;
+        qsort(counts, response->num_records, sizeof(ServiceCount), compare_hits);
+        printf("Counts over %u shots (%u outcomes):\n", options->shots, response->num_records);
+        for (uint32_t k = 0; k < response->num_records && k < STATE_PRINT_LIMIT; k++) {
+            printf("|");
+            quantum_utils_print_binary((int)counts[k].outcome, n);
+            printf("⟩: %u\n", counts[k].hits);
+        }
+        if (response->num_records > STATE_PRINT_LIMIT) {
+            printf("... %u less frequent outcomes not shown\n", response->num_records - STATE_PRINT_LIMIT);
+        }
+    } else if (options->result == SERVICE_RESULT_EXPECTATION) {
+        const double *values = payload;
+        double total = 0.0;
+        for (uint32_t k = 0; k < response->num_records; k++) {
+            printf("Term %u: %.10f\n", k, values[k]);
+            total += values[k];
+        }
+        printf("Expectation: %.10f\n", total);
+    } else if (options->result == SERVICE_RESULT_STATE) {
+        QuantumState *state = quantum_state_create(n);
+        if (!state) return;
+        memcpy(state->amplitudes, payload, (size_t)response->payload_bytes);
+        quantum_state_print(state);
+        quantum_state_destroy(state);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    ClientOptions options;
+    if (!parse_options(argc, argv, &options)) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    ServiceRequest request;
+    memset(&request, 0, sizeof(request));
+    memcpy(request.magic, SERVICE_REQUEST_MAGIC, sizeof(request.magic));
+    request.result = options.result;
+    request.shots = options.shots;
+    request.num_terms = (uint32_t)options.num_terms;
+    request.num_parameters = (uint32_t)options.num_parameters;
+
+    char *circuit = NULL;
+    if (options.circuit_path) {
+        size_t length;
+        circuit = read_file(options.circuit_path, &length);
+        if (!circuit) return 1;
+        request.circuit_bytes = length;
+        request.format = length >= sizeof(CircuitFileHeader) &&
+                         memcmp(circuit, CIRCUIT_FILE_MAGIC, strlen(CIRCUIT_FILE_MAGIC)) == 0
+                         ? SERVICE_FORMAT_BINARY : SERVICE_FORMAT_QASM;
+    }
+
+    int fd = quantum_service_connect(options.socket_path);
+    if (fd < 0) {
+        free(circuit);
+        return 1;
+    }
+
+    ServiceResponse response;
+    void *payload = NULL;
+    double round_trip = 0.0, service_time = 0.0;
+    int status = 0;
+
+    for (int k = 0; k < options.repeat && status == 0; k++) {
+        free(payload);
+        double start = quantum_profile_seconds();
+        if (!quantum_service_submit(fd, &request, circuit, options.terms, options.parameters, &response, &payload)) {
+            status = 1;
+            break;
+        }
+        round_trip += quantum_profile_seconds() - start;
+        service_time += response.seconds;
+        if (response.status != SERVICE_STATUS_OK) {
+            fprintf(stderr, "Error: Service rejected the job: %s\n", (char *)payload);
+            status = 1;
+        }
+    }
+
+    if (status == 0 && options.result != SERVICE_RESULT_SHUTDOWN) {
+        print_result(&options, &response, payload);
+        if (options.repeat > 1) {
+            printf("%d jobs: %.1f us round trip, %.1f us in the service per job\n", options.repeat,
+                   1e6 * round_trip / options.repeat, 1e6 * service_time / options.repeat);
+        }
+    }
+
+    free(payload);
+    free(circuit);
+    close(fd);
+    return status;
+}
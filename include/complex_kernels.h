@@ -0,0 +1,140 @@
+#ifndef COMPLEX_KERNELS_H
+#define COMPLEX_KERNELS_H
+
+#include <stddef.h>
+#include <math.h>
+#include "complex_math.h"
+
+/**
+ * Inline complex arithmetic for the amplitude loops
+ * The functions in complex_math.c are separate calls the compiler cannot see
+ * into, which keeps a loop that uses them scalar. These versions are visible
+ * at every call site and the batch forms are written as simd loops, so a
+ * loop built from them can be vectorised. Strides are in elements; callers
+ * pass literal strides so they are constants once inlined.
+ */
+
+static inline Complex complex_kernel_add(Complex a, Complex b) {
+    Complex c = {a.real + b.real, a.imag + b.imag};
+    return c;
+}
+
+static inline Complex complex_kernel_subtract(Complex a, Complex b) {
+    Complex c = {a.real - b.real, a.imag - b.imag};
+    return c;
+}
+
+static inline Complex complex_kernel_multiply(Complex a, Complex b) {
+    Complex c = {a.real * b.real - a.imag * b.imag, a.real * b.imag + a.imag * b.real};
+    return c;
+}
+
+/* conj(a) * b */
+static inline Complex complex_kernel_conjugate_multiply(Complex a, Complex b) {
+    Complex c = {a.real * b.real + a.imag * b.imag, a.real * b.imag - a.imag * b.real};
+    return c;
+}
+
+static inline double complex_kernel_magnitude_squared(Complex a) {
+    return a.real * a.real + a.imag * a.imag;
+}
+
+static inline Complex complex_kernel_from_polar(double magnitude, double phase) {
+    Complex c = {magnitude * cos(phase), magnitude * sin(phase)};
+    return c;
+}
+
+/* Batch operations over count elements */
+
+/* x[k * stride] *= alpha */
+static inline void complex_kernel_scale(Complex *x, size_t count, size_t stride, Complex alpha) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        x[k * stride] = complex_kernel_multiply(x[k * stride], alpha);
+    }
+}
+
+/* x[k * stride] *= alpha for real alpha */
+static inline void complex_kernel_scale_real(Complex *x, size_t count, size_t stride, double alpha) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        x[k * stride].real *= alpha;
+        x[k * stride].imag *= alpha;
+    }
+}
+
+/* x[k * stride] = 0 */
+static inline void complex_kernel_zero(Complex *x, size_t count, size_t stride) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        x[k * stride].real = 0.0;
+        x[k * stride].imag = 0.0;
+    }
+}
+
+/* Exchanges x[k * stride] and y[k * stride] */
+static inline void complex_kernel_swap(Complex *restrict x, Complex *restrict y, size_t count, size_t stride) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        Complex temp = x[k * stride];
+        x[k * stride] = y[k * stride];
+        y[k * stride] = temp;
+    }
+}
+
+/* y[k] += alpha * x[k] */
+static inline void complex_kernel_axpy(Complex *restrict y, const Complex *restrict x, size_t count, Complex alpha) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        y[k] = complex_kernel_add(y[k], complex_kernel_multiply(alpha, x[k]));
+    }
+}
+
+/* Σ conj(x[k]) * y[k] */
+static inline Complex complex_kernel_dot(const Complex *x, const Complex *y, size_t count) {
+    double real = 0.0, imag = 0.0;
+    #pragma omp simd reduction(+:real, imag)
+    for (size_t k = 0; k < count; k++) {
+        Complex term = complex_kernel_conjugate_multiply(x[k], y[k]);
+        real += term.real;
+        imag += term.imag;
+    }
+    Complex c = {real, imag};
+    return c;
+}
+
+/* Σ |x[k]|² */
+static inline double complex_kernel_norm_squared(const Complex *x, size_t count) {
+    double sum = 0.0;
+    #pragma omp simd reduction(+:sum)
+    for (size_t k = 0; k < count; k++) {
+        sum += complex_kernel_magnitude_squared(x[k]);
+    }
+    return sum;
+}
+
+/* (lo, hi) ← [m00 m01; m10 m11] (lo, hi) for each pair lo[k * stride], hi[k * stride] */
+static inline void complex_kernel_apply_2x2(Complex *restrict lo, Complex *restrict hi, size_t count, size_t stride,
+                                            Complex m00, Complex m01, Complex m10, Complex m11) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        Complex a0 = lo[k * stride], a1 = hi[k * stride];
+        lo[k * stride] = complex_kernel_add(complex_kernel_multiply(m00, a0), complex_kernel_multiply(m01, a1));
+        hi[k * stride] = complex_kernel_add(complex_kernel_multiply(m10, a0), complex_kernel_multiply(m11, a1));
+    }
+}
+
+/* As complex_kernel_apply_2x2 for a real matrix, at half the multiplies */
+static inline void complex_kernel_apply_real_2x2(Complex *restrict lo, Complex *restrict hi, size_t count, size_t stride,
+                                                 double m00, double m01, double m10, double m11) {
+    #pragma omp simd
+    for (size_t k = 0; k < count; k++) {
+        Complex a0 = lo[k * stride], a1 = hi[k * stride];
+        lo[k * stride].real = m00 * a0.real + m01 * a1.real;
+        lo[k * stride].imag = m00 * a0.imag + m01 * a1.imag;
+        hi[k * stride].real = m10 * a0.real + m11 * a1.real;
+        hi[k * stride].imag = m10 * a0.imag + m11 * a1.imag;
+    }
+}
+
+#endif
@@ -11,7 +11,7 @@ typedef struct {
     double imag;
 } Complex;
 
-/* Complex number operations */
+/* Complex number operations (inline versions for loops are in complex_kernels.h) */
 Complex complex_create(double real, double imag);
 Complex complex_add(Complex a, Complex b);
 Complex complex_subtract(Complex a, Complex b);
@@ -0,0 +1,41 @@
+#ifndef QUANTUM_BATCH_H
+#define QUANTUM_BATCH_H
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+/**
+ * Batch of B states of the same size, stored amplitude-major and batch-minor
+ * with split real/imaginary parts: amplitude i of state b is
+ * (real[i * B + b], imag[i * B + b]). Every gate is applied to all B states
+ * in one pass whose inner loop runs over the batch, so it vectorises even
+ * for small qubit counts.
+ */
+typedef struct {
+    int num_qubits;
+    int num_states;
+    int batch_size;
+    double *real;
+    double *imag;
+    double *matrices;   /* Per-batch 2x2 matrix scratch, 8 * batch_size */
+} QuantumBatch;
+
+/* Batch management */
+QuantumBatch* quantum_batch_create(int num_qubits, int batch_size);
+void quantum_batch_destroy(QuantumBatch *batch);
+void quantum_batch_initialise_zero(QuantumBatch *batch);
+int quantum_batch_load_state(QuantumBatch *batch, int index, const QuantumState *state);
+int quantum_batch_store_state(const QuantumBatch *batch, int index, QuantumState *state);
+double quantum_batch_get_probability(const QuantumBatch *batch, int index, int basis_state);
+
+/* Batched gate kernels */
+void quantum_batch_apply_matrix(QuantumBatch *batch, int qubit, const Complex *matrices, int per_batch);
+void quantum_batch_cnot(QuantumBatch *batch, int control, int target);
+void quantum_batch_cz(QuantumBatch *batch, int control, int target);
+void quantum_batch_swap(QuantumBatch *batch, int qubit1, int qubit2);
+
+/* Runs a circuit on every state; parameters is batch_size x num_parameters
+ * (row per state) or NULL to use the circuit's own parameter values */
+int quantum_batch_execute(const QuantumCircuit *circuit, QuantumBatch *batch, const double *parameters);
+
+#endif
@@ -1,9 +1,14 @@
 #ifndef QUANTUM_CIRCUIT_H
 #define QUANTUM_CIRCUIT_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "quantum_state.h"
+#include "quantum_gates.h"
 
 #define MAX_GATES 1000
+#define MAX_PARAMETERS 512
+#define MAX_PARAMETER_NAME 32
 
 typedef enum {
     GATE_PAULI_X,
@@ -18,7 +23,12 @@ typedef enum {
     GATE_CZ,
     GATE_SWAP,
     GATE_MEASURE,
-    GATE_MEASURE_ALL
+    GATE_MEASURE_ALL,
+    GATE_QFT,   /* qubit1..qubit2 inclusive */
+    GATE_IQFT,  /* qubit1..qubit2 inclusive */
+    GATE_ORACLE, /* qubit1 = input register, qubit2 = output register */
+    GATE_CONTROLLED_PHASE,
+    NUM_GATE_TYPES  /* Count, not a gate */
 } GateType;
 
 typedef struct {
@@ -26,6 +36,8 @@ typedef struct {
     int qubit1;
     int qubit2;  /* For two-qubit gates, -1 for single-qubit gates */
     double parameter;  /* For parameterised gates */
+    int parameter_index;  /* Symbolic parameter bound at execution, -1 if fixed */
+    const QuantumOracle *oracle;  /* For GATE_ORACLE, owned by the caller */
 } QuantumGate;
 
 typedef struct {
@@ -33,8 +45,51 @@ typedef struct {
     int num_gates;
     QuantumGate gates[MAX_GATES];
     char description[256];
+    int num_parameters;
+    char parameter_names[MAX_PARAMETERS][MAX_PARAMETER_NAME];
 } QuantumCircuit;
 
+/**
+ * Binary circuit file (native byte order)
+ * Header, then num_gates fixed-width records, then num_parameters names of
+ * MAX_PARAMETER_NAME bytes. The checksum is FNV-1a over everything after the
+ * header. Files are not limited to MAX_GATES, so a mapped file can hold a
+ * circuit far larger than a QuantumCircuit.
+ */
+#define CIRCUIT_FILE_MAGIC "QCIRCBIN"
+#define CIRCUIT_FILE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_qubits;
+    uint64_t num_gates;
+    uint32_t num_parameters;
+    uint32_t record_size;
+    uint64_t checksum;
+    char description[216];
+} CircuitFileHeader;
+
+typedef struct {
+    uint32_t type;
+    int32_t qubit1;
+    int32_t qubit2;
+    int32_t parameter_index;
+    double parameter;
+} CircuitFileRecord;
+
+/* Read-only mapping of a validated circuit file, executed in place */
+typedef struct {
+    void *base;
+    size_t length;
+    const CircuitFileHeader *header;
+    const CircuitFileRecord *records;
+    const char (*parameter_names)[MAX_PARAMETER_NAME];
+} MappedCircuit;
+
+/* Incremental writer so chunked producers can emit more than MAX_GATES gates */
+typedef struct CircuitFileWriter CircuitFileWriter;
+
 /* Circuit management */
 QuantumCircuit* quantum_circuit_create(int num_qubits, const char* description);
 void quantum_circuit_destroy(QuantumCircuit *circuit);
@@ -52,11 +107,40 @@ int quantum_circuit_add_rotation_z(QuantumCircuit *circuit, int qubit, double an
 int quantum_circuit_add_cnot(QuantumCircuit *circuit, int control, int target);
 int quantum_circuit_add_cz(QuantumCircuit *circuit, int control, int target);
 int quantum_circuit_add_swap(QuantumCircuit *circuit, int qubit1, int qubit2);
+int quantum_circuit_add_controlled_phase(QuantumCircuit *circuit, int control, int target, double phase);
 int quantum_circuit_add_measure(QuantumCircuit *circuit, int qubit);
 int quantum_circuit_add_measure_all(QuantumCircuit *circuit);
+int quantum_circuit_add_qft(QuantumCircuit *circuit, int first_qubit, int last_qubit);
+int quantum_circuit_add_inverse_qft(QuantumCircuit *circuit, int first_qubit, int last_qubit);
+int quantum_circuit_add_oracle(QuantumCircuit *circuit, const QuantumOracle *oracle);
+
+/* Symbolic parameters (RX/RY/RZ/Phase angles bound at execution) */
+int quantum_circuit_add_parameter(QuantumCircuit *circuit, const char *name);
+int quantum_circuit_find_parameter(const QuantumCircuit *circuit, const char *name);
+int quantum_circuit_add_parameterised_gate(QuantumCircuit *circuit, GateType type, int qubit, int parameter_index);
+int quantum_circuit_bind_parameters(QuantumCircuit *circuit, const double *values);
+int quantum_circuit_is_parameterisable(GateType type);
 
 /* Circuit execution */
 int quantum_circuit_execute(const QuantumCircuit *circuit, QuantumState *state);
+int quantum_circuit_apply_gate(const QuantumGate *gate, QuantumState *state, int *measurement);
+
+/* Gate introspection */
+const char* gate_type_to_string(GateType type);
+int quantum_circuit_is_single_qubit_unitary(GateType type);
+unsigned int quantum_circuit_gate_qubits(const QuantumGate *gate, int num_qubits);
+
+/* Binary circuit files (oracle gates cannot be serialised) */
+int quantum_circuit_save_binary(const QuantumCircuit *circuit, const char *path);
+QuantumCircuit* quantum_circuit_load_binary(const char *path);
+CircuitFileWriter* quantum_circuit_writer_open(const char *path, int num_qubits, const char *description);
+int quantum_circuit_writer_append(CircuitFileWriter *writer, const QuantumCircuit *circuit);
+int quantum_circuit_writer_close(CircuitFileWriter *writer);
+MappedCircuit* quantum_circuit_map_binary(const char *path);
+void quantum_circuit_unmap_binary(MappedCircuit *mapped);
+/* Validates a circuit file image already in memory; view borrows data and is not unmapped */
+int quantum_circuit_view_binary(const void *data, size_t length, MappedCircuit *view);
+int quantum_circuit_execute_mapped(const MappedCircuit *mapped, QuantumState *state, const double *parameters);
 
 /* Circuit utilities */
 void quantum_circuit_print(const QuantumCircuit *circuit);
@@ -0,0 +1,43 @@
+#ifndef QUANTUM_DISTRIBUTED_H
+#define QUANTUM_DISTRIBUTED_H
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+#define DISTRIBUTED_MAX_PROCESSES 64
+
+/**
+ * Multi-process state vector
+ * The amplitudes are split across P = 2^k worker processes by the top k
+ * qubits. Each rank applies local-qubit gates to its slice with the ordinary
+ * gate kernels. A gate on a global qubit first swaps that qubit with a local
+ * one: every rank exchanges half of its slice with the partner rank that
+ * differs in the global bit. The original qubit order is restored before the
+ * slices are gathered back into the caller's state.
+ *
+ * Transports implement a pairwise exchange. Shared memory keeps the slices
+ * in one shared mapping; sockets keep each slice private to its process, as
+ * on separate nodes. QFTs are expanded into H, controlled-phase and SWAP
+ * gates. Measurement and oracles are not supported.
+ */
+typedef enum {
+    DISTRIBUTED_TRANSPORT_SHARED_MEMORY,
+    DISTRIBUTED_TRANSPORT_SOCKETS
+} DistributedTransportType;
+
+typedef struct {
+    int num_processes;  /* Power of two, one OpenMP thread each */
+    DistributedTransportType transport;
+} DistributedOptions;
+
+typedef struct {
+    int exchanges;               /* Global-qubit swaps, each involving every rank */
+    long long bytes_exchanged;   /* Sent by all ranks */
+    double seconds;
+} DistributedStats;
+
+/* Scatters state, runs the circuit across processes and gathers the result into state */
+int quantum_distributed_execute(const QuantumCircuit *circuit, QuantumState *state,
+                                const DistributedOptions *options, DistributedStats *stats);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef QUANTUM_EXECUTOR_H
+#define QUANTUM_EXECUTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+/**
+ * Concurrent execution of many independent circuits
+ * Circuits are ordered by cost (amplitudes × gates). Those of at least
+ * large_qubits qubits run first, one at a time, with every OpenMP thread
+ * inside their gate loops. The rest are dealt largest-first onto one deque
+ * per worker; a worker runs single-threaded from the front of its own deque
+ * and, once that is empty, steals the back half of another worker's deque,
+ * so the many small circuits at the end balance across the workers.
+ *
+ * Circuit i draws its samples and measurements from random stream (seed, i),
+ * so results do not depend on the worker count or on which worker ran it.
+ * Workers keep one state per qubit count and reuse it for every circuit of
+ * that size.
+ */
+#define EXECUTOR_DEFAULT_LARGE_QUBITS 16
+
+typedef struct {
+    int num_workers;   /* 0 for the OpenMP thread count */
+    int large_qubits;  /* 0 for EXECUTOR_DEFAULT_LARGE_QUBITS */
+    int shots;         /* Samples per circuit, 0 for none */
+    int keep_states;   /* Copy each final state into the results */
+    uint64_t seed;
+} ExecutorOptions;
+
+/**
+ * Results in contiguous arrays indexed by circuit. A circuit with measure
+ * gates is re-run for every shot; its kept state is the last run's.
+ */
+typedef struct {
+    int num_circuits;
+    int shots;
+    int *outcomes;          /* num_circuits × shots, row per circuit; NULL without shots */
+    size_t *state_offsets;  /* num_circuits + 1 entries into amplitudes; NULL without keep_states */
+    Complex *amplitudes;    /* Final states back to back */
+    int *succeeded;         /* 0 where a circuit failed; its outcomes are -1 */
+    int num_failed;
+} ExecutorResults;
+
+ExecutorResults* quantum_executor_run(const QuantumCircuit *const *circuits, int num_circuits,
+                                      const ExecutorOptions *options);
+void quantum_executor_results_destroy(ExecutorResults *results);
+
+#endif
@@ -3,6 +3,24 @@
 
 #include "quantum_state.h"
 
+/**
+ * Classical-function oracle |x⟩|y⟩ → |x⟩|y ⊕ f(x)⟩
+ * Both registers are contiguous qubit ranges starting at the given qubit,
+ * least significant bit first. Only the low output_width bits of f(x) are used.
+ * gate_oracle calls f from an OpenMP parallel loop, in no fixed order, so f
+ * must be pure and thread-safe: no counters, caches or other writes to context.
+ */
+typedef unsigned int (*OracleFunction)(unsigned int input, void *context);
+
+typedef struct {
+    int input_qubit;
+    int input_width;
+    int output_qubit;
+    int output_width;
+    OracleFunction function;
+    void *context;
+} QuantumOracle;
+
 /* Single qubit gates */
 void gate_pauli_x(QuantumState *state, int qubit);
 void gate_pauli_y(QuantumState *state, int qubit);
@@ -12,11 +30,23 @@ void gate_phase(QuantumState *state, int qubit, double phase);
 void gate_rotation_x(QuantumState *state, int qubit, double angle);
 void gate_rotation_y(QuantumState *state, int qubit, double angle);
 void gate_rotation_z(QuantumState *state, int qubit, double angle);
+/* Arbitrary 2x2 matrix, row-major {m00, m01, m10, m11} */
+void gate_unitary(QuantumState *state, int qubit, const Complex matrix[4]);
 
 /* Two qubit gates */
 void gate_cnot(QuantumState *state, int control, int target);
 void gate_cz(QuantumState *state, int control, int target);
 void gate_swap(QuantumState *state, int qubit1, int qubit2);
+void gate_controlled_phase(QuantumState *state, int control, int target, double phase);
+
+/* Multi-qubit transforms on the contiguous qubit range [first_qubit, last_qubit] */
+void gate_qft(QuantumState *state, int first_qubit, int last_qubit);
+void gate_inverse_qft(QuantumState *state, int first_qubit, int last_qubit);
+/* QFT with first_qubit as the most significant bit (textbook circuit ordering) */
+void gate_qft_msb_first(QuantumState *state, int first_qubit, int last_qubit);
+
+/* Reversible classical function applied as a single permutation pass */
+void gate_oracle(QuantumState *state, const QuantumOracle *oracle);
 
 /* Utility gates */
 void gate_identity(QuantumState *state, int qubit);
@@ -24,5 +54,6 @@ void gate_identity(QuantumState *state, int qubit);
 /* Gate validation */
 int validate_single_qubit_gate(const QuantumState *state, int qubit);
 int validate_two_qubit_gate(const QuantumState *state, int qubit1, int qubit2);
+int validate_oracle(int num_qubits, const QuantumOracle *oracle);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef QUANTUM_GRADIENT_H
+#define QUANTUM_GRADIENT_H
+
+#include "quantum_program.h"
+#include "quantum_observable.h"
+
+/**
+ * Adjoint-method gradients
+ * Computes E = ⟨ψ|H|ψ⟩ for ψ = U(θ)|initial⟩ and dE/dθ_p for every program
+ * parameter with one forward run and one backward sweep over two state
+ * buffers. Parameters used by several gates accumulate their contributions.
+ * The program must be bound and must not contain measurements.
+ */
+int quantum_gradient_adjoint(const QuantumProgram *program, const PauliObservable *observable,
+                             const QuantumState *initial_state, double *expectation, double *gradients);
+
+#endif
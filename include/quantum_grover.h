@@ -0,0 +1,47 @@
+#ifndef QUANTUM_GROVER_H
+#define QUANTUM_GROVER_H
+
+#include "quantum_state.h"
+#include <stdint.h>
+
+#define GROVER_COUNT_UNKNOWN -1
+
+/**
+ * Block predicate for marked states
+ * Sets marked[k] non-zero if basis state first_index + k is a solution.
+ * Called on blocks of consecutive indices so the body can be vectorised.
+ */
+typedef void (*GroverPredicate)(int first_index, int count, unsigned char *marked, void *context);
+
+/**
+ * Bitmap of marked basis states
+ */
+typedef struct {
+    int num_qubits;
+    int num_states;
+    int num_marked;
+    uint64_t *bits;
+} GroverMarkSet;
+
+typedef struct {
+    int found;            /* 1 if result is a marked state */
+    int result;           /* Measured basis state */
+    int iterations;       /* Total Grover iterations applied */
+    int rounds;           /* Prepare-iterate-measure rounds */
+    double success_probability;  /* Marked-state probability before the final measurement */
+} GroverResult;
+
+/* Mark set management */
+GroverMarkSet* quantum_grover_marks_create(int num_qubits);
+GroverMarkSet* quantum_grover_marks_from_predicate(int num_qubits, GroverPredicate predicate, void *context);
+void quantum_grover_marks_destroy(GroverMarkSet *marks);
+void quantum_grover_marks_add(GroverMarkSet *marks, int index);
+int quantum_grover_marks_contains(const GroverMarkSet *marks, int index);
+
+/* Engine */
+int quantum_grover_optimal_iterations(int num_states, int num_marked);
+double quantum_grover_marked_probability(const QuantumState *state, const GroverMarkSet *marks);
+void quantum_grover_iterate(QuantumState *state, const GroverMarkSet *marks, int iterations);
+GroverResult quantum_grover_search(QuantumState *state, const GroverMarkSet *marks, int num_marked);
+
+#endif
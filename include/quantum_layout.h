@@ -0,0 +1,41 @@
+#ifndef QUANTUM_LAYOUT_H
+#define QUANTUM_LAYOUT_H
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+/**
+ * Qubit layout for split states
+ * The out-of-core and distributed backends both split a state into blocks
+ * addressed by the low `local` physical positions, and move logical qubits
+ * between positions so every gate only touches local ones. The layout keeps
+ * the logical/physical maps and chooses the moves: a gate's global qubits
+ * evict the local qubits whose next use is furthest ahead. Backends supply
+ * only the data movement for one exchange of two positions.
+ */
+
+/* Exchanges the data of physical positions p1 < p2; called before the maps
+ * are updated, so occupant[] still names the qubits being moved. Returns 0
+ * on failure. */
+typedef int (*LayoutSwapFunction)(void *context, int p1, int p2);
+
+typedef struct {
+    int num_qubits;
+    int local;                          /* Positions addressed within a block */
+    int physical[MAX_MAPPED_QUBITS];    /* Logical qubit -> physical position */
+    int occupant[MAX_MAPPED_QUBITS];    /* Physical position -> logical qubit */
+    LayoutSwapFunction swap;
+    void *context;
+} QuantumLayout;
+
+/* Starts from the identity layout */
+void quantum_layout_init(QuantumLayout *layout, int num_qubits, int local,
+                         LayoutSwapFunction swap, void *context);
+int quantum_layout_is_local(const QuantumLayout *layout, const QuantumGate *gate);
+
+/* Each returns 0 as soon as a data movement fails */
+int quantum_layout_swap(QuantumLayout *layout, int p1, int p2);
+int quantum_layout_localise(QuantumLayout *layout, const QuantumGate *gates, int num_gates, int index);
+int quantum_layout_restore(QuantumLayout *layout);
+
+#endif
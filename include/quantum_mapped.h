@@ -0,0 +1,35 @@
+#ifndef QUANTUM_MAPPED_H
+#define QUANTUM_MAPPED_H
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+#define MAPPED_DEFAULT_LOCAL_QUBITS 22  /* 64 MB chunks */
+
+/**
+ * Out-of-core execution for states larger than memory
+ * The state is split into chunks of 2^local_qubits amplitudes. Runs of gates
+ * acting only on local (in-chunk) qubits are applied chunk by chunk in one
+ * streaming pass. A gate on a global qubit first exchanges that qubit with
+ * the local qubit whose next use is furthest away, which costs one pass over
+ * pairs of chunks. Measurements, QFTs and oracles see the whole state in its
+ * original qubit order. The order is always restored before returning.
+ */
+typedef struct {
+    int local_qubits;     /* 0 selects MAPPED_DEFAULT_LOCAL_QUBITS */
+    int report_progress;  /* Print a line per pass */
+} MappedExecutionOptions;
+
+typedef struct {
+    int passes;           /* Streaming passes applying local gates */
+    int swap_passes;      /* Passes reorganising chunks to localise a qubit */
+    int global_gates;     /* Gates applied to the whole state */
+    long long gates;
+    long long bytes_streamed;
+    double seconds;
+} MappedExecutionStats;
+
+int quantum_mapped_execute(const QuantumCircuit *circuit, QuantumState *state,
+                           const MappedExecutionOptions *options, MappedExecutionStats *stats);
+
+#endif
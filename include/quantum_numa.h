@@ -0,0 +1,36 @@
+#ifndef QUANTUM_NUMA_H
+#define QUANTUM_NUMA_H
+
+#include <stddef.h>
+#include "complex_math.h"
+
+/**
+ * NUMA placement for amplitude arrays
+ * Amplitudes are allocated untouched and then zeroed in parallel with a static
+ * schedule. Under the default first-touch policy each thread's share of the
+ * array therefore lands on its own node, matching the static schedules used by
+ * the gate kernels. The interleave policy spreads pages round-robin over all
+ * nodes instead, for access patterns with no stable owner.
+ */
+typedef enum {
+    NUMA_POLICY_FIRST_TOUCH,
+    NUMA_POLICY_INTERLEAVE
+} NumaPolicy;
+
+void quantum_numa_set_policy(NumaPolicy policy);
+NumaPolicy quantum_numa_get_policy(void);
+int quantum_numa_num_nodes(void);
+
+/* Page-aligned and not yet touched; from 2 MB up the array is a separate
+ * mapping aligned for transparent huge pages */
+Complex* quantum_numa_alloc_amplitudes(size_t count);
+void quantum_numa_free_amplitudes(Complex *amplitudes, size_t count);
+
+/* Pins each OpenMP thread to one allowed CPU, spread evenly; returns threads pinned */
+int quantum_numa_pin_threads(void);
+
+/* Applies QUANTUM_NUMA_POLICY=interleave|first-touch and QUANTUM_PIN_THREADS=1.
+ * Pinning is left to the runtime when OMP_PROC_BIND is set. */
+void quantum_numa_initialise(void);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef QUANTUM_OBSERVABLE_H
+#define QUANTUM_OBSERVABLE_H
+
+#include "quantum_state.h"
+#include <stdint.h>
+
+/**
+ * Pauli string as X/Z bitmasks: bit q of x_mask and z_mask selects
+ * I (0,0), X (1,0), Z (0,1) or Y (1,1) on qubit q.
+ */
+typedef struct {
+    uint32_t x_mask;
+    uint32_t z_mask;
+    double coefficient;
+} PauliTerm;
+
+/**
+ * Weighted sum of Pauli strings, grouped by X mask
+ * Terms with the same X mask pair the same amplitudes and share a pass.
+ */
+typedef struct {
+    int num_qubits;
+    int num_terms;
+    PauliTerm *terms;       /* Sorted by x_mask */
+    int *term_order;        /* Caller's index of each sorted term */
+    int num_groups;
+    int *group_start;       /* num_groups + 1 offsets into terms */
+} PauliObservable;
+
+/* Observable management */
+PauliObservable* quantum_observable_create(int num_qubits, const PauliTerm *terms, int num_terms);
+void quantum_observable_destroy(PauliObservable *observable);
+
+/* Expectation values (read-only, no state copies) */
+double quantum_pauli_expectation(const QuantumState *state, PauliTerm term);
+double quantum_observable_expectation(const PauliObservable *observable, const QuantumState *state);
+void quantum_observable_term_expectations(const PauliObservable *observable, const QuantumState *state, double *values);
+
+/* ⟨bra|P|ket⟩ for a single Pauli string, including its coefficient */
+Complex quantum_pauli_matrix_element(const QuantumState *bra, PauliTerm term, const QuantumState *ket);
+
+/* output = H·input, where output is a distinct state of the same size */
+int quantum_observable_apply(const PauliObservable *observable, const QuantumState *input, QuantumState *output);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef QUANTUM_OPTIMISE_H
+#define QUANTUM_OPTIMISE_H
+
+#include "quantum_circuit.h"
+
+/**
+ * Peephole circuit optimiser
+ * Each gate is moved forward past the gates it commutes with until it meets
+ * one it does not. If that gate is its inverse (X, Y, Z, H, CNOT, CZ, SWAP)
+ * both are removed; if it is the same fixed-angle rotation (RX, RY, RZ,
+ * phase, controlled phase) on the same qubits the angles are added and
+ * rotations that reduce to the identity are removed. Gates commute when they
+ * share no qubits or, on every shared qubit, both are diagonal in the Z basis
+ * or both in the X basis. Measurement, QFT and oracle gates are barriers on
+ * their qubits. Passes repeat until nothing changes; the circuit's unitary is
+ * preserved exactly, so every removed gate is one state pass saved.
+ */
+typedef struct {
+    int gates_before;
+    int gates_after;
+    int cancelled;   /* Gates removed as inverse pairs */
+    int merged;      /* Rotations folded into a later rotation */
+    int dropped;     /* Rotations removed as the identity */
+    int passes;
+} OptimiseStats;
+
+/* Optimises circuit in place; returns the number of gates removed */
+int quantum_optimise_circuit(QuantumCircuit *circuit, OptimiseStats *stats);
+
+/**
+ * Light-cone pruning
+ * Only the outcomes of the observed qubits matter (0 observes every qubit).
+ * If the circuit measures, those outcomes are its measurements of observed
+ * qubits; otherwise they are the final state's observed qubits. Walking
+ * backwards, a gate survives only if it touches a qubit that can still
+ * influence an outcome, which also removes everything after the last
+ * measurement. Diagonal gates (Z, phase, RZ, CZ, controlled phase) whose
+ * qubits are all measured next are removed as well, since they cannot change
+ * a computational-basis outcome.
+ *
+ * The surviving gates often touch fewer qubits than the register. Restricting
+ * renumbers them onto just those qubits, so the circuit can be simulated from
+ * |0...0> on a much smaller state. Bits of an expanded basis index that belong
+ * to dropped qubits are zero, and are only meaningful for observed qubits.
+ */
+typedef struct {
+    int gates_before;
+    int gates_after;
+    int outside_light_cone;     /* Including gates after the last measurement */
+    int diagonal_before_measurement;
+    unsigned int active_qubits; /* Qubits the surviving gates or outcomes involve */
+} LightConeStats;
+
+typedef struct {
+    int num_qubits;                   /* Of the restricted circuit */
+    int qubits[MAX_MAPPED_QUBITS];    /* Restricted qubit i is original qubit qubits[i] */
+} QubitRestriction;
+
+/* Prunes circuit in place; returns the number of gates removed */
+int quantum_optimise_light_cone(QuantumCircuit *circuit, unsigned int observed, LightConeStats *stats);
+
+/* New circuit on only the active qubits; oracle gates keep every qubit */
+QuantumCircuit* quantum_optimise_restrict(const QuantumCircuit *circuit, unsigned int observed,
+                                          QubitRestriction *restriction);
+int quantum_optimise_expand_index(const QubitRestriction *restriction, int index);
+
+/* Prunes and restricts a copy of circuit, then runs it from |0...0>; returns the
+ * restricted state, which may still be in product form */
+QuantumState* quantum_optimise_run_light_cone(const QuantumCircuit *circuit, unsigned int observed,
+                                              QubitRestriction *restriction, LightConeStats *stats);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef QUANTUM_POOL_H
+#define QUANTUM_POOL_H
+
+#include <stddef.h>
+#include "complex_math.h"
+
+/**
+ * Amplitude buffer pool
+ * Heap states take their amplitudes from here and hand them back when
+ * destroyed. Buffers are kept in one size class per power of two, so a
+ * create/copy/destroy loop reuses pages that are already faulted in and
+ * placed instead of asking the kernel for fresh zeroed ones each time.
+ * Fresh buffers come from quantum_numa_alloc_amplitudes (page-aligned,
+ * huge-page backed from 2 MB). The pool is shared by all threads.
+ */
+#define POOL_DEFAULT_LIMIT_BYTES ((size_t)256 << 20)
+#define POOL_CLASS_DEPTH 8  /* Cached buffers per size class */
+
+typedef struct {
+    size_t hits;          /* Acquires served from the pool */
+    size_t misses;        /* Acquires that allocated */
+    size_t cached_bytes;  /* Held for reuse now */
+} PoolStats;
+
+/* Contents are undefined. Only power-of-two counts are pooled; others are
+ * allocated and freed each time. */
+Complex* quantum_pool_acquire(size_t count);
+void quantum_pool_release(Complex *amplitudes, size_t count);
+
+/* Most bytes kept for reuse; lowering it trims the pool. 0 disables pooling. */
+void quantum_pool_set_limit(size_t bytes);
+void quantum_pool_trim(void);
+void quantum_pool_get_stats(PoolStats *stats);
+
+#endif
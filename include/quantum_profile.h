@@ -0,0 +1,49 @@
+#ifndef QUANTUM_PROFILE_H
+#define QUANTUM_PROFILE_H
+
+#include "quantum_circuit.h"
+
+/**
+ * Execution profiler
+ * While a profile is active, every gate applied through
+ * quantum_circuit_apply_gate (and so quantum_circuit_execute and
+ * quantum_circuit_execute_mapped) is timed and charged to its gate type and
+ * target qubit. Bytes are the amplitude traffic the kernel is expected to
+ * read and write, so bytes / seconds is the achieved bandwidth. With no active
+ * profile the executor only tests one pointer per gate. Fused single-qubit
+ * blocks run by quantum_program_execute are charged to their own row.
+ */
+typedef struct {
+    long long calls;
+    double seconds;
+    double bytes;
+} ProfileCounter;
+
+typedef struct {
+    ProfileCounter gate_types[NUM_GATE_TYPES];
+    ProfileCounter fused;  /* Fused single-qubit blocks, one call per block */
+    ProfileCounter target_qubits[MAX_MAPPED_QUBITS];  /* Whole-register gates are not charged here */
+    ProfileCounter total;
+} ExecutionProfile;
+
+/* Clears profile and records into it until stopped; NULL is the same as stopping.
+ * Starting and stopping are safe while other threads apply gates, but the
+ * counters are plain sums: only one thread at a time may apply gates while a
+ * profile is active, and it is read after stopping. */
+void quantum_profile_start(ExecutionProfile *profile);
+void quantum_profile_stop(void);
+ExecutionProfile* quantum_profile_active(void);
+
+void quantum_profile_reset(ExecutionProfile *profile);
+void quantum_profile_record(ExecutionProfile *profile, const QuantumGate *gate, int num_qubits, double seconds);
+void quantum_profile_record_fused(ExecutionProfile *profile, int qubit, int num_qubits, double seconds);
+double quantum_profile_seconds(void);  /* Monotonic clock used for samples */
+
+/* Estimated amplitude bytes read plus written by one application of gate */
+double quantum_profile_gate_bytes(const QuantumGate *gate, int num_qubits);
+double quantum_profile_bandwidth(const ProfileCounter *counter);  /* GB/s */
+
+/* Summary table by gate type and by target qubit, most expensive first */
+void quantum_profile_print(const ExecutionProfile *profile);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef QUANTUM_PROGRAM_H
+#define QUANTUM_PROGRAM_H
+
+#include "quantum_circuit.h"
+
+/**
+ * Compiled circuit
+ * Validated once, with runs of single-qubit gates on the same qubit fused
+ * into one 2x2 matrix. Binding parameter values only rebuilds the matrices
+ * that depend on changed parameters; binding and execution never allocate.
+ */
+typedef enum {
+    PROGRAM_OP_MATRIX,   /* Fused single-qubit gates */
+    PROGRAM_OP_GATE      /* Any other gate, applied as-is */
+} ProgramOpType;
+
+typedef struct {
+    ProgramOpType type;
+    int qubit;              /* Target of a matrix op */
+    int first_gate;         /* First source gate, further ones via gate_next */
+    int num_gates;
+    int parameterised;
+    Complex matrix[4];      /* Row-major product of the source gates */
+} ProgramOp;
+
+typedef struct {
+    int num_qubits;
+    int num_parameters;
+    int num_gates;
+    QuantumGate *gates;      /* Source gates with the bound parameter values */
+    int *gate_next;          /* Next source gate of the same op, -1 at the end */
+    int *gate_op;            /* Op each source gate was fused into */
+    int num_ops;
+    ProgramOp *ops;
+    int *parameter_op_start; /* Ops depending on parameter p: */
+    int *parameter_ops;      /*   parameter_ops[start[p] .. start[p + 1]) */
+    unsigned char *op_dirty;
+    double *bound_values;
+    int is_bound;
+} QuantumProgram;
+
+/* Program management */
+QuantumProgram* quantum_program_compile(const QuantumCircuit *circuit);
+void quantum_program_destroy(QuantumProgram *program);
+
+/* Binding and execution */
+int quantum_program_bind(QuantumProgram *program, const double *values);
+int quantum_program_execute(const QuantumProgram *program, QuantumState *state);
+int quantum_program_run(QuantumProgram *program, const double *values, QuantumState *state);
+
+/* Matrix of a single-qubit gate at its current parameter */
+void quantum_program_gate_matrix(const QuantumGate *gate, Complex matrix[4]);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef QUANTUM_QASM_H
+#define QUANTUM_QASM_H
+
+#include <stdio.h>
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+
+#define QASM_MAX_REGISTERS 16
+#define QASM_READ_BLOCK (1 << 20)
+
+/**
+ * Streaming OpenQASM 2.0 reader (qelib1 subset)
+ * Statements are parsed from large buffered reads into a chunk circuit of at
+ * most MAX_GATES gates. Each full chunk is handed to a handler and cleared, so
+ * memory stays bounded regardless of the file length.
+ *
+ * Supported: OPENQASM, include, qreg, creg, barrier, measure, and the gates
+ * id x y z h s sdg t tdg sx sxdg rx ry rz p u1 u2 u3 u U cx CX cy cz swap
+ * cp cu1 crz ccx cswap, with register broadcasting. Custom gate
+ * definitions, opaque, if and reset are rejected.
+ */
+typedef struct {
+    long long statements;
+    long long gates;
+    long long gates_removed;  /* By the optimiser when running */
+    long long measurements;   /* measure statements */
+    long long bytes;
+    int chunks;
+    int num_qubits;
+} QasmStats;
+
+/* Called with each full chunk and with the final partial chunk */
+typedef int (*QasmChunkHandler)(QuantumCircuit *chunk, void *context);
+
+int quantum_qasm_stream(FILE *file, QasmChunkHandler handler, void *context, QasmStats *stats);
+
+/* Whole file into one circuit (at most MAX_GATES gates) */
+QuantumCircuit* quantum_qasm_parse_file(const char *path);
+
+/* Streams the file into a binary circuit file (quantum_circuit_map_binary)
+ * chunk by chunk, so the output is not limited to MAX_GATES gates */
+int quantum_qasm_compile_file(const char *path, const char *binary_path, QasmStats *stats);
+
+/* Streams the file through fused programs on a state starting in |0...0⟩,
+ * kept in product form until the first entangling gate */
+QuantumState* quantum_qasm_run_file(const char *path, QasmStats *stats);
+
+/* As quantum_qasm_run_file on an open stream. With an allocator the state
+ * comes from allocate once the register size is known, and on failure it is
+ * left for the caller to reclaim instead of being destroyed. */
+typedef QuantumState* (*QasmStateAllocator)(int num_qubits, void *context);
+QuantumState* quantum_qasm_run_stream(FILE *file, QasmStateAllocator allocate, void *context, QasmStats *stats);
+
+#endif
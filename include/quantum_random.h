@@ -0,0 +1,30 @@
+#ifndef QUANTUM_RANDOM_H
+#define QUANTUM_RANDOM_H
+
+#include <stdint.h>
+
+/**
+ * Seedable random streams (xoshiro256**)
+ * rand() is one process-wide sequence behind a lock, so threads measuring
+ * at once contend for it and no run can be repeated. A QuantumRandom is a
+ * private stream; (seed, stream) pairs give independent sequences, so a
+ * job can own the stream numbered after it and get the same samples on any
+ * thread. Measurement draws from the calling thread's stream when one is
+ * set and from rand() otherwise.
+ */
+typedef struct {
+    uint64_t s[4];
+} QuantumRandom;
+
+void quantum_random_seed(QuantumRandom *random, uint64_t seed, uint64_t stream);
+uint64_t quantum_random_next(QuantumRandom *random);
+/* Uniform in [0, 1) */
+double quantum_random_double(QuantumRandom *random);
+
+/* Stream used by measurements on the calling thread; NULL restores rand() */
+void quantum_random_set_thread_stream(QuantumRandom *random);
+QuantumRandom* quantum_random_thread_stream(void);
+/* Uniform in [0, 1] from the thread's stream, or from rand() seeded on first use */
+double quantum_random_uniform(void);
+
+#endif
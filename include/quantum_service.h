@@ -0,0 +1,92 @@
+#ifndef QUANTUM_SERVICE_H
+#define QUANTUM_SERVICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "quantum_state.h"
+#include "quantum_observable.h"
+
+/**
+ * Simulator service over a Unix-domain socket
+ * A long-running process accepts jobs on a local socket and runs them on a
+ * pool of worker threads, so a job costs a round trip instead of a process
+ * start. Each job is a request header, the circuit (OpenQASM text or a
+ * binary circuit file image), then num_terms PauliTerm records and
+ * num_parameters doubles. The reply is a response header and its records.
+ * Everything is in native byte order, as the socket is local.
+ *
+ * Requests on one connection run in order, one at a time, so clients can
+ * pipeline them; separate connections run in parallel on the workers.
+ * States are taken from a pool keyed by qubit count and returned after
+ * each job, so a steady stream of jobs does not allocate amplitudes.
+ */
+#define SERVICE_REQUEST_MAGIC "QSRQ"
+#define SERVICE_RESPONSE_MAGIC "QSRS"
+#define SERVICE_MAX_CIRCUIT_BYTES (256u << 20)
+#define SERVICE_MAX_TERMS 65536
+#define SERVICE_MAX_SHOTS 100000000u
+#define SERVICE_DEFAULT_WORKERS 4
+
+typedef enum {
+    SERVICE_FORMAT_QASM,
+    SERVICE_FORMAT_BINARY
+} ServiceFormat;
+
+typedef enum {
+    SERVICE_RESULT_COUNTS,       /* shots samples of the final register */
+    SERVICE_RESULT_EXPECTATION,  /* ⟨P_k⟩ for each PauliTerm sent */
+    SERVICE_RESULT_STATE,        /* All amplitudes */
+    SERVICE_RESULT_SHUTDOWN      /* No circuit; stops the service */
+} ServiceResult;
+
+typedef enum {
+    SERVICE_STATUS_OK,
+    SERVICE_STATUS_ERROR  /* Payload is the message text */
+} ServiceStatus;
+
+typedef struct {
+    char magic[4];
+    uint32_t format;          /* ServiceFormat */
+    uint32_t result;          /* ServiceResult */
+    uint32_t shots;
+    uint32_t num_terms;
+    uint32_t num_parameters;  /* Binary circuits only */
+    uint64_t circuit_bytes;
+} ServiceRequest;
+
+typedef struct {
+    char magic[4];
+    uint32_t status;       /* ServiceStatus */
+    uint32_t num_qubits;
+    uint32_t num_records;  /* ServiceCount, double or Complex records */
+    uint64_t payload_bytes;
+    double seconds;        /* Time spent running the job */
+} ServiceResponse;
+
+/* Counts come back sorted by outcome, one record per outcome seen */
+typedef struct {
+    uint32_t outcome;
+    uint32_t hits;
+} ServiceCount;
+
+typedef struct {
+    const char *socket_path;
+    int num_workers;
+    int preallocate_qubits;  /* One pooled state per worker at this size, 0 for none */
+} ServiceOptions;
+
+/* Serves until a shutdown request, SIGINT or SIGTERM; returns 1 on a clean stop */
+int quantum_service_run(const ServiceOptions *options);
+
+/* Client side: connect, then any number of submits on the connection */
+int quantum_service_connect(const char *socket_path);
+
+/* Sends one job and waits for its reply. On success *payload holds the
+ * response records (free() it) and the return is 1; a job the service
+ * rejected also returns 1 with SERVICE_STATUS_ERROR. Returns 0 when the
+ * connection fails. */
+int quantum_service_submit(int fd, const ServiceRequest *request, const void *circuit,
+                           const PauliTerm *terms, const double *parameters,
+                           ServiceResponse *response, void **payload);
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef QUANTUM_SNAPSHOT_H
+#define QUANTUM_SNAPSHOT_H
+
+#include <stddef.h>
+#include "quantum_state.h"
+
+/**
+ * Copy-on-write state snapshots
+ * A snapshot holds one read-only copy of a state in an anonymous memory file.
+ * Each branch is a private mapping of that file, so branches share its pages
+ * until a kernel writes to one; the kernel then copies just that 4 KB page
+ * (256 amplitudes) for that branch. A branch costs a mapping, not a 2^n
+ * copy, and keeps only the pages it has modified.
+ *
+ * The snapshot is reference counted: its creator holds one reference and every
+ * live branch holds another, so the creator can release it as soon as the
+ * branches are made. Branches are ordinary states; quantum_state_destroy
+ * releases their reference.
+ */
+QuantumSnapshot* quantum_snapshot_create(const QuantumState *state);
+QuantumSnapshot* quantum_snapshot_retain(QuantumSnapshot *snapshot);
+void quantum_snapshot_release(QuantumSnapshot *snapshot);
+
+QuantumState* quantum_snapshot_branch(QuantumSnapshot *snapshot);
+/* Discards a branch's modified pages, returning it to the snapshot's state */
+int quantum_snapshot_reset(QuantumState *branch);
+
+#endif
@@ -2,9 +2,38 @@
 #define QUANTUM_STATE_H
 
 #include "complex_math.h"
+#include "quantum_random.h"
 
 #define MAX_QUBITS 20
 #define MAX_STATES (1 << MAX_QUBITS)  /* 2^20 */
+#define MAX_MAPPED_QUBITS 30  /* File-backed states, 16 GB at the limit */
+
+/* Loops over fewer amplitudes than this stay on one thread. Larger ones use a
+ * static schedule everywhere, so each thread keeps touching the pages it
+ * first touched when the state was created (see quantum_numa.h). */
+#define QUANTUM_PARALLEL_THRESHOLD (1 << 14)
+
+typedef enum {
+    QUANTUM_STORAGE_HEAP,     /* Buffer from the amplitude pool (quantum_pool.h) */
+    QUANTUM_STORAGE_MAPPED,   /* Amplitudes are a shared mapping of a file */
+    QUANTUM_STORAGE_SNAPSHOT  /* Private copy-on-write mapping of a snapshot */
+} QuantumStorage;
+
+typedef struct QuantumSnapshot QuantumSnapshot;  /* See quantum_snapshot.h */
+
+/**
+ * Lazy product form
+ * A state with product form enabled starts each preparation and each
+ * measure-all result as one normalised 2-vector per qubit (a basis state is
+ * the special case with one non-zero entry per qubit). Single-qubit gates then
+ * update one 2-vector, and controlled gates stay factored while their control
+ * is a basis state. The dense amplitudes are only written when a gate would
+ * entangle qubits, or when code needs them.
+ */
+typedef enum {
+    QUANTUM_FORM_DENSE,
+    QUANTUM_FORM_PRODUCT  /* amplitudes are stale; qubit q is factors[2q], factors[2q + 1] */
+} QuantumForm;
 
 /**
  * Quantum state representation
@@ -14,12 +43,27 @@ typedef struct {
     int num_qubits;
     int num_states;  /* 2^num_qubits */
     Complex *amplitudes;
+    QuantumStorage storage;
+    QuantumForm form;
+    Complex *factors;  /* NULL unless product form is enabled */
+    QuantumSnapshot *snapshot;  /* Source of a snapshot branch, NULL otherwise */
 } QuantumState;
 
 /* State management */
 QuantumState* quantum_state_create(int num_qubits);
 void quantum_state_destroy(QuantumState *state);
 QuantumState* quantum_state_copy(const QuantumState *state);
+/* File-backed state of up to MAX_MAPPED_QUBITS; a NULL path uses an unlinked temporary file */
+QuantumState* quantum_state_create_mapped(int num_qubits, const char *path);
+
+/* Product form; code writing amplitudes directly must materialise first.
+ * Const readers never materialise, so they can share a state across threads:
+ * read_amplitudes returns the dense amplitudes, or expands product-form
+ * factors into *scratch, which release_amplitudes gives back. */
+int quantum_state_enable_product_form(QuantumState *state);
+void quantum_state_materialise(QuantumState *state);
+const Complex* quantum_state_read_amplitudes(const QuantumState *state, Complex **scratch);
+void quantum_state_release_amplitudes(const QuantumState *state, Complex *scratch);
 
 /* State initialisation */
 void quantum_state_initialise_zero(QuantumState *state);
@@ -35,7 +79,56 @@ int quantum_state_is_normalised(const QuantumState *state, double tolerance);
 int quantum_state_measure_all(QuantumState *state);
 int quantum_state_measure_qubit(QuantumState *state, int qubit_index);
 
-/* Utility functions */
+/**
+ * Sampling without collapse
+ * cumulative fills num_states running probabilities and returns their total
+ * (negative on failure); draw takes one outcome from them by binary search.
+ * sample does both for shots outcomes, with scratch holding num_states
+ * doubles. Unlike measurement, the state is only read.
+ */
+double quantum_state_cumulative(const QuantumState *state, double *cumulative);
+int quantum_state_draw(const double *cumulative, int num_states, double total, QuantumRandom *random);
+int quantum_state_sample(const QuantumState *state, QuantumRandom *random, int shots, double *scratch, int *out);
+
+/**
+ * Marginal distribution of the qubits in qubit_mask, in one pass over the
+ * state. out receives 2^k probabilities for k selected qubits; bit j of a bin
+ * is the j-th lowest selected qubit. Few bins are accumulated in per-thread
+ * histograms; many bins are computed one bin per iteration instead.
+ */
+#define MARGINAL_PRIVATE_QUBITS 12
+
+int quantum_state_marginal(const QuantumState *state, unsigned int qubit_mask, double *out);
+
+/**
+ * The k most likely basis states, most likely first (ties by lower index).
+ * Each thread keeps a bounded min-heap of its best k, and the heaps are merged
+ * at the end, so the state is scanned once and never sorted.
+ */
+typedef struct {
+    int index;
+    double probability;
+    Complex amplitude;
+} StateOutcome;
+
+#define STATE_PRINT_LIMIT 32  /* Outcomes shown by the print functions */
+
+/* Fills out with min(k, num_states) outcomes; returns how many */
+int quantum_state_top_k(const QuantumState *state, int k, StateOutcome *out);
+
+/**
+ * Binary checkpoints
+ * Amplitudes are stored raw in fixed 1 MB chunks at 4096-aligned offsets,
+ * written and read in parallel. All-zero chunks are elided and left as file
+ * holes; every stored chunk carries a checksum. Saves go through a temporary
+ * file and a rename, so an interrupted save never replaces a good checkpoint.
+ */
+#define CHECKPOINT_CHUNK_BYTES (1 << 20)
+
+int quantum_state_save(const QuantumState *state, const char *path);
+QuantumState* quantum_state_restore(const char *path);
+
+/* Utility functions: the STATE_PRINT_LIMIT most likely outcomes above 1e-10 */
 void quantum_state_print(const QuantumState *state);
 void quantum_state_print_probabilities(const QuantumState *state);
 
@@ -1,4 +1,5 @@
 #include "complex_math.h"
+#include "complex_kernels.h"
 #include <math.h>
 #include <stdio.h>
 
@@ -8,17 +9,15 @@ Complex complex_create(double real, double imag) {
 }
 
 Complex complex_add(Complex a, Complex b) {
-    return complex_create(a.real + b.real, a.imag + b.imag);
+    return complex_kernel_add(a, b);
 }
 
 Complex complex_subtract(Complex a, Complex b) {
-    return complex_create(a.real - b.real, a.imag - b.imag);
+    return complex_kernel_subtract(a, b);
 }
 
 Complex complex_multiply(Complex a, Complex b) {
-    double real = a.real * b.real - a.imag * b.imag;
-    double imag = a.real * b.imag + a.imag * b.real;
-    return complex_create(real, imag);
+    return complex_kernel_multiply(a, b);
 }
 
 Complex complex_divide(Complex a, Complex b) {
@@ -37,11 +36,11 @@ double complex_magnitude(Complex a) {
 }
 
 double complex_magnitude_squared(Complex a) {
-    return a.real * a.real + a.imag * a.imag;
+    return complex_kernel_magnitude_squared(a);
 }
 
 Complex complex_from_polar(double magnitude, double phase) {
-    return complex_create(magnitude * cos(phase), magnitude * sin(phase));
+    return complex_kernel_from_polar(magnitude, phase);
 }
 
 void complex_print(Complex c) {
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
 /* Define M_PI if not available */
@@ -12,6 +13,10 @@
 #include "quantum_circuit.h"
 #include "quantum_utils.h"
 #include "complex_math.h"
+#include "quantum_qasm.h"
+#include "quantum_numa.h"
+#include "quantum_profile.h"
+#include "quantum_service.h"
 
 void print_welcome_message(void) {
     printf("╔═════════════════════════════════════════════════════════════════╗\n");
@@ -285,7 +290,70 @@ void interactive_mode(void) {
     quantum_state_destroy(state);
 }
 
-int main(void) {
+/* Non-interactive: stream an OpenQASM file and print the final distribution */
+int qasm_mode(const char *path, int profile_gates) {
+    QasmStats stats;
+    ExecutionProfile profile;
+    
+    if (profile_gates) quantum_profile_start(&profile);
+    QuantumState *state = quantum_qasm_run_file(path, &stats);
+    quantum_profile_stop();
+    if (!state) return 1;
+
+    printf("Executed %s: %lld statements, %lld gates (%lld optimised away), %d qubits in %d chunk(s)\n",
+           path, stats.statements, stats.gates, stats.gates_removed, stats.num_qubits, stats.chunks);
+    quantum_state_print_probabilities(state);
+    if (profile_gates) quantum_profile_print(&profile);
+
+    quantum_state_destroy(state);
+    return 0;
+}
+
+/* Non-interactive: convert an OpenQASM file to a binary circuit file */
+int compile_mode(const char *path, const char *binary_path) {
+    QasmStats stats;
+    if (!quantum_qasm_compile_file(path, binary_path, &stats)) return 1;
+
+    printf("Compiled %s to %s: %lld gates on %d qubits in %d chunk(s)\n",
+           path, binary_path, stats.gates, stats.num_qubits, stats.chunks);
+    return 0;
+}
+
+/* Daemon: --serve SOCKET [--workers N] [--preallocate QUBITS] */
+int serve_mode(int argc, char *argv[]) {
+    ServiceOptions options = {argv[2], SERVICE_DEFAULT_WORKERS, 0};
+    
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options.num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--preallocate") == 0 && i + 1 < argc) {
+            options.preallocate_qubits = atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s --serve SOCKET [--workers N] [--preallocate QUBITS]\n", argv[0]);
+            return 1;
+        }
+    }
+    return quantum_service_run(&options) ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    quantum_numa_initialise();
+    
+    if (argc >= 3 && strcmp(argv[1], "--serve") == 0) {
+        return serve_mode(argc, argv);
+    }
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--qasm") == 0) {
+        int profile_gates = argc == 4 && strcmp(argv[3], "--profile") == 0;
+        if (argc == 4 && !profile_gates) {
+            fprintf(stderr, "Usage: %s --qasm FILE [--profile]\n", argv[0]);
+            return 1;
+        }
+        return qasm_mode(argv[2], profile_gates);
+    }
+    if (argc == 4 && strcmp(argv[1], "--compile") == 0) {
+        return compile_mode(argv[2], argv[3]);
+    }
+
     print_welcome_message();
     interactive_mode();
     
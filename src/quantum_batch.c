@@ -0,0 +1,309 @@
+#include "quantum_batch.h"
+#include "quantum_gates.h"
+#include "quantum_program.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+QuantumBatch* quantum_batch_create(int num_qubits, int batch_size) {
+    if (num_qubits < 1 || num_qubits > MAX_QUBITS) {
+        fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_QUBITS);
+        return NULL;
+    }
+    if (batch_size < 1) {
+        fprintf(stderr, "Error: Batch size must be positive\n");
+        return NULL;
+    }
+    
+    QuantumBatch *batch = malloc(sizeof(QuantumBatch));
+    if (!batch) {
+        fprintf(stderr, "Error: Failed to allocate memory for quantum batch\n");
+        return NULL;
+    }
+    
+    batch->num_qubits = num_qubits;
+    batch->num_states = 1 << num_qubits;
+    batch->batch_size = batch_size;
+    
+    size_t count = (size_t)batch->num_states * batch_size;
+    batch->real = calloc(count, sizeof(double));
+    batch->imag = calloc(count, sizeof(double));
+    batch->matrices = malloc(8 * (size_t)batch_size * sizeof(double));
+    if (!batch->real || !batch->imag || !batch->matrices) {
+        fprintf(stderr, "Error: Failed to allocate memory for batch amplitudes\n");
+        quantum_batch_destroy(batch);
+        return NULL;
+    }
+    
+    return batch;
+}
+
+void quantum_batch_destroy(QuantumBatch *batch) {
+    if (batch) {
+        free(batch->real);
+        free(batch->imag);
+        free(batch->matrices);
+        free(batch);
+    }
+}
+
+void quantum_batch_initialise_zero(QuantumBatch *batch) {
+    if (!batch) return;
+    
+    size_t count = (size_t)batch->num_states * batch->batch_size;
+    memset(batch->real, 0, count * sizeof(double));
+    memset(batch->imag, 0, count * sizeof(double));
+    for (int b = 0; b < batch->batch_size; b++) {
+        batch->real[b] = 1.0;
+    }
+}
+
+static int validate_batch_index(const QuantumBatch *batch, int index, const QuantumState *state) {
+    if (!batch || !state) {
+        fprintf(stderr, "Error: Null batch or state\n");
+        return 0;
+    }
+    if (index < 0 || index >= batch->batch_size) {
+        fprintf(stderr, "Error: Batch index %d out of range [0, %d)\n", index, batch->batch_size);
+        return 0;
+    }
+    if (state->num_qubits != batch->num_qubits) {
+        fprintf(stderr, "Error: Batch and state have different numbers of qubits\n");
+        return 0;
+    }
+    return 1;
+}
+
+int quantum_batch_load_state(QuantumBatch *batch, int index, const QuantumState *state) {
+    if (!validate_batch_index(batch, index, state)) return 0;
+    
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0;
+    
+    int stride = batch->batch_size;
+    for (int i = 0; i < batch->num_states; i++) {
+        batch->real[(size_t)i * stride + index] = amplitudes[i].real;
+        batch->imag[(size_t)i * stride + index] = amplitudes[i].imag;
+    }
+    quantum_state_release_amplitudes(state, scratch);
+    return 1;
+}
+
+int quantum_batch_store_state(const QuantumBatch *batch, int index, QuantumState *state) {
+    if (!validate_batch_index(batch, index, state)) return 0;
+    
+    int stride = batch->batch_size;
+    state->form = QUANTUM_FORM_DENSE;  /* Every amplitude is overwritten */
+    for (int i = 0; i < batch->num_states; i++) {
+        state->amplitudes[i] = complex_create(batch->real[(size_t)i * stride + index],
+                                              batch->imag[(size_t)i * stride + index]);
+    }
+    return 1;
+}
+
+double quantum_batch_get_probability(const QuantumBatch *batch, int index, int basis_state) {
+    if (!batch || index < 0 || index >= batch->batch_size ||
+        basis_state < 0 || basis_state >= batch->num_states) {
+        return 0.0;
+    }
+    size_t k = (size_t)basis_state * batch->batch_size + index;
+    return batch->real[k] * batch->real[k] + batch->imag[k] * batch->imag[k];
+}
+
+// =============================================================================
+// BATCHED KERNELS
+// =============================================================================
+
+/* matrices: 4 Complex entries (row-major) shared by the batch, or
+ * 4 * batch_size entries with one matrix per state if per_batch is set */
+void quantum_batch_apply_matrix(QuantumBatch *batch, int qubit, const Complex *matrices, int per_batch) {
+    if (!batch || !matrices || qubit < 0 || qubit >= batch->num_qubits) {
+        fprintf(stderr, "Error: Invalid batched gate\n");
+        return;
+    }
+    
+    int B = batch->batch_size;
+    
+    /* Split the matrices into one contiguous lane array per entry */
+    double *m_real[4], *m_imag[4];
+    for (int e = 0; e < 4; e++) {
+        m_real[e] = batch->matrices + (size_t)(2 * e) * B;
+        m_imag[e] = batch->matrices + (size_t)(2 * e + 1) * B;
+        for (int b = 0; b < B; b++) {
+            Complex m = matrices[per_batch ? 4 * b + e : e];
+            m_real[e][b] = m.real;
+            m_imag[e][b] = m.imag;
+        }
+    }
+    
+    int qubit_mask = 1 << qubit;
+    int num_pairs = batch->num_states / 2;
+    double *restrict re = batch->real;
+    double *restrict im = batch->imag;
+    
+    #pragma omp parallel for schedule(static)
+    for (int p = 0; p < num_pairs; p++) {
+        int i0 = ((p >> qubit) << (qubit + 1)) | (p & (qubit_mask - 1));
+        int i1 = i0 | qubit_mask;
+        double *restrict r0 = re + (size_t)i0 * B, *restrict r1 = re + (size_t)i1 * B;
+        double *restrict c0 = im + (size_t)i0 * B, *restrict c1 = im + (size_t)i1 * B;
+        
+        #pragma omp simd
+        for (int b = 0; b < B; b++) {
+            double ar = r0[b], ai = c0[b], br = r1[b], bi = c1[b];
+            r0[b] = m_real[0][b] * ar - m_imag[0][b] * ai + m_real[1][b] * br - m_imag[1][b] * bi;
+            c0[b] = m_real[0][b] * ai + m_imag[0][b] * ar + m_real[1][b] * bi + m_imag[1][b] * br;
+            r1[b] = m_real[2][b] * ar - m_imag[2][b] * ai + m_real[3][b] * br - m_imag[3][b] * bi;
+            c1[b] = m_real[2][b] * ai + m_imag[2][b] * ar + m_real[3][b] * bi + m_imag[3][b] * br;
+        }
+    }
+}
+
+static void swap_rows(QuantumBatch *batch, int i, int j) {
+    int B = batch->batch_size;
+    double *restrict ri = batch->real + (size_t)i * B, *restrict rj = batch->real + (size_t)j * B;
+    double *restrict ci = batch->imag + (size_t)i * B, *restrict cj = batch->imag + (size_t)j * B;
+    
+    #pragma omp simd
+    for (int b = 0; b < B; b++) {
+        double t = ri[b]; ri[b] = rj[b]; rj[b] = t;
+        t = ci[b]; ci[b] = cj[b]; cj[b] = t;
+    }
+}
+
+static int validate_batch_pair(const QuantumBatch *batch, int qubit1, int qubit2) {
+    if (!batch || qubit1 < 0 || qubit2 < 0 || qubit1 >= batch->num_qubits ||
+        qubit2 >= batch->num_qubits || qubit1 == qubit2) {
+        fprintf(stderr, "Error: Invalid batched two-qubit gate\n");
+        return 0;
+    }
+    return 1;
+}
+
+void quantum_batch_cnot(QuantumBatch *batch, int control, int target) {
+    if (!validate_batch_pair(batch, control, target)) return;
+    
+    int control_mask = 1 << control;
+    int target_mask = 1 << target;
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < batch->num_states; i++) {
+        if ((i & control_mask) && !(i & target_mask)) {
+            swap_rows(batch, i, i | target_mask);
+        }
+    }
+}
+
+void quantum_batch_cz(QuantumBatch *batch, int control, int target) {
+    if (!validate_batch_pair(batch, control, target)) return;
+    
+    int both = (1 << control) | (1 << target);
+    int B = batch->batch_size;
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < batch->num_states; i++) {
+        if ((i & both) == both) {
+            double *restrict r = batch->real + (size_t)i * B;
+            double *restrict c = batch->imag + (size_t)i * B;
+            #pragma omp simd
+            for (int b = 0; b < B; b++) {
+                r[b] = -r[b];
+                c[b] = -c[b];
+            }
+        }
+    }
+}
+
+void quantum_batch_swap(QuantumBatch *batch, int qubit1, int qubit2) {
+    if (!validate_batch_pair(batch, qubit1, qubit2)) return;
+    
+    int mask1 = 1 << qubit1;
+    int mask2 = 1 << qubit2;
+    
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < batch->num_states; i++) {
+        if ((i & mask1) && !(i & mask2)) {
+            swap_rows(batch, i, i ^ mask1 ^ mask2);
+        }
+    }
+}
+
+// =============================================================================
+// BATCHED EXECUTION
+// =============================================================================
+
+/* Gates without a batched kernel go through a QuantumState, one state at a time */
+static int apply_unbatched(QuantumBatch *batch, const QuantumGate *gate, QuantumState *scratch) {
+    for (int b = 0; b < batch->batch_size; b++) {
+        quantum_batch_store_state(batch, b, scratch);
+        if (!quantum_circuit_apply_gate(gate, scratch, NULL)) return 0;
+        quantum_batch_load_state(batch, b, scratch);
+    }
+    return 1;
+}
+
+int quantum_batch_execute(const QuantumCircuit *circuit, QuantumBatch *batch, const double *parameters) {
+    if (!circuit || !batch) {
+        fprintf(stderr, "Error: Null circuit or batch\n");
+        return 0;
+    }
+    if (circuit->num_qubits != batch->num_qubits) {
+        fprintf(stderr, "Error: Circuit and batch have different numbers of qubits\n");
+        return 0;
+    }
+    
+    int B = batch->batch_size;
+    Complex *matrices = malloc(4 * (size_t)B * sizeof(Complex));
+    QuantumState *scratch = NULL;
+    if (!matrices) {
+        fprintf(stderr, "Error: Failed to allocate memory for batch matrices\n");
+        return 0;
+    }
+    
+    int success = 1;
+    for (int i = 0; i < circuit->num_gates && success; i++) {
+        const QuantumGate *gate = &circuit->gates[i];
+        
+        if (quantum_circuit_is_single_qubit_unitary(gate->type)) {
+            if (gate->parameter_index >= 0 && parameters) {
+                /* One matrix per state from its own parameter row */
+                QuantumGate bound = *gate;
+                for (int b = 0; b < B; b++) {
+                    bound.parameter = parameters[(size_t)b * circuit->num_parameters + gate->parameter_index];
+                    quantum_program_gate_matrix(&bound, &matrices[4 * b]);
+                }
+                quantum_batch_apply_matrix(batch, gate->qubit1, matrices, 1);
+            } else {
+                quantum_program_gate_matrix(gate, matrices);
+                quantum_batch_apply_matrix(batch, gate->qubit1, matrices, 0);
+            }
+            continue;
+        }
+        
+        switch (gate->type) {
+            case GATE_CNOT:
+                quantum_batch_cnot(batch, gate->qubit1, gate->qubit2);
+                break;
+            case GATE_CZ:
+                quantum_batch_cz(batch, gate->qubit1, gate->qubit2);
+                break;
+            case GATE_SWAP:
+                quantum_batch_swap(batch, gate->qubit1, gate->qubit2);
+                break;
+            case GATE_MEASURE:
+            case GATE_MEASURE_ALL:
+                fprintf(stderr, "Error: Batched execution does not support measurement gates\n");
+                success = 0;
+                break;
+            default:
+                if (!scratch) scratch = quantum_state_create(batch->num_qubits);
+                success = scratch && apply_unbatched(batch, gate, scratch);
+                break;
+        }
+    }
+    
+    quantum_state_destroy(scratch);
+    free(matrices);
+    return success;
+}
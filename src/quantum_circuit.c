@@ -1,12 +1,17 @@
 #include "quantum_circuit.h"
 #include "quantum_gates.h"
+#include "quantum_profile.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 QuantumCircuit* quantum_circuit_create(int num_qubits, const char* description) {
-    if (num_qubits < 1 || num_qubits > MAX_QUBITS) {
-        fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_QUBITS);
+    if (num_qubits < 1 || num_qubits > MAX_MAPPED_QUBITS) {
+        fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_MAPPED_QUBITS);
         return NULL;
     }
     
@@ -18,6 +23,7 @@ QuantumCircuit* quantum_circuit_create(int num_qubits, const char* description)
     
     circuit->num_qubits = num_qubits;
     circuit->num_gates = 0;
+    circuit->num_parameters = 0;
     
     if (description) {
         strncpy(circuit->description, description, sizeof(circuit->description) - 1);
@@ -61,6 +67,8 @@ int quantum_circuit_add_gate(QuantumCircuit *circuit, GateType type, int qubit1,
     gate->qubit1 = qubit1;
     gate->qubit2 = qubit2;
     gate->parameter = parameter;
+    gate->parameter_index = -1;
+    gate->oracle = NULL;
     
     circuit->num_gates++;
     return 1;
@@ -122,6 +130,14 @@ int quantum_circuit_add_swap(QuantumCircuit *circuit, int qubit1, int qubit2) {
     return quantum_circuit_add_gate(circuit, GATE_SWAP, qubit1, qubit2, 0.0);
 }
 
+int quantum_circuit_add_controlled_phase(QuantumCircuit *circuit, int control, int target, double phase) {
+    if (control == target) {
+        fprintf(stderr, "Error: Control and target qubits cannot be the same\n");
+        return 0;
+    }
+    return quantum_circuit_add_gate(circuit, GATE_CONTROLLED_PHASE, control, target, phase);
+}
+
 int quantum_circuit_add_measure(QuantumCircuit *circuit, int qubit) {
     return quantum_circuit_add_gate(circuit, GATE_MEASURE, qubit, -1, 0.0);
 }
@@ -130,6 +146,181 @@ int quantum_circuit_add_measure_all(QuantumCircuit *circuit) {
     return quantum_circuit_add_gate(circuit, GATE_MEASURE_ALL, 0, -1, 0.0);
 }
 
+int quantum_circuit_add_qft(QuantumCircuit *circuit, int first_qubit, int last_qubit) {
+    if (first_qubit > last_qubit) {
+        fprintf(stderr, "Error: QFT range must have first qubit <= last qubit\n");
+        return 0;
+    }
+    return quantum_circuit_add_gate(circuit, GATE_QFT, first_qubit, last_qubit, 0.0);
+}
+
+int quantum_circuit_add_inverse_qft(QuantumCircuit *circuit, int first_qubit, int last_qubit) {
+    if (first_qubit > last_qubit) {
+        fprintf(stderr, "Error: QFT range must have first qubit <= last qubit\n");
+        return 0;
+    }
+    return quantum_circuit_add_gate(circuit, GATE_IQFT, first_qubit, last_qubit, 0.0);
+}
+
+int quantum_circuit_add_oracle(QuantumCircuit *circuit, const QuantumOracle *oracle) {
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return 0;
+    }
+    if (!validate_oracle(circuit->num_qubits, oracle)) return 0;
+    
+    if (!quantum_circuit_add_gate(circuit, GATE_ORACLE, oracle->input_qubit, oracle->output_qubit, 0.0)) {
+        return 0;
+    }
+    circuit->gates[circuit->num_gates - 1].oracle = oracle;
+    return 1;
+}
+
+int quantum_circuit_is_parameterisable(GateType type) {
+    return type == GATE_PHASE || type == GATE_ROTATION_X ||
+           type == GATE_ROTATION_Y || type == GATE_ROTATION_Z;
+}
+
+int quantum_circuit_find_parameter(const QuantumCircuit *circuit, const char *name) {
+    if (!circuit || !name) return -1;
+    
+    for (int i = 0; i < circuit->num_parameters; i++) {
+        if (strcmp(circuit->parameter_names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+int quantum_circuit_add_parameter(QuantumCircuit *circuit, const char *name) {
+    if (!circuit || !name) {
+        fprintf(stderr, "Error: Null circuit or parameter name\n");
+        return -1;
+    }
+    
+    int existing = quantum_circuit_find_parameter(circuit, name);
+    if (existing >= 0) return existing;
+    
+    if (circuit->num_parameters >= MAX_PARAMETERS) {
+        fprintf(stderr, "Error: Circuit has reached maximum number of parameters (%d)\n", MAX_PARAMETERS);
+        return -1;
+    }
+    
+    char *slot = circuit->parameter_names[circuit->num_parameters];
+    strncpy(slot, name, MAX_PARAMETER_NAME - 1);
+    slot[MAX_PARAMETER_NAME - 1] = '\0';
+    return circuit->num_parameters++;
+}
+
+int quantum_circuit_add_parameterised_gate(QuantumCircuit *circuit, GateType type, int qubit, int parameter_index) {
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return 0;
+    }
+    if (!quantum_circuit_is_parameterisable(type)) {
+        fprintf(stderr, "Error: Gate type does not take a parameter\n");
+        return 0;
+    }
+    if (parameter_index < 0 || parameter_index >= circuit->num_parameters) {
+        fprintf(stderr, "Error: Parameter %d out of range [0, %d)\n", parameter_index, circuit->num_parameters);
+        return 0;
+    }
+    
+    if (!quantum_circuit_add_gate(circuit, type, qubit, -1, 0.0)) return 0;
+    circuit->gates[circuit->num_gates - 1].parameter_index = parameter_index;
+    return 1;
+}
+
+int quantum_circuit_bind_parameters(QuantumCircuit *circuit, const double *values) {
+    if (!circuit || (!values && circuit->num_parameters > 0)) {
+        fprintf(stderr, "Error: Null circuit or parameter values\n");
+        return 0;
+    }
+    
+    for (int i = 0; i < circuit->num_gates; i++) {
+        QuantumGate *gate = &circuit->gates[i];
+        if (gate->parameter_index >= 0) {
+            gate->parameter = values[gate->parameter_index];
+        }
+    }
+    return 1;
+}
+
+static int apply_gate_kernel(const QuantumGate *gate, QuantumState *state, int *measurement) {
+    switch (gate->type) {
+        case GATE_PAULI_X:
+            gate_pauli_x(state, gate->qubit1);
+            break;
+        case GATE_PAULI_Y:
+            gate_pauli_y(state, gate->qubit1);
+            break;
+        case GATE_PAULI_Z:
+            gate_pauli_z(state, gate->qubit1);
+            break;
+        case GATE_HADAMARD:
+            gate_hadamard(state, gate->qubit1);
+            break;
+        case GATE_PHASE:
+            gate_phase(state, gate->qubit1, gate->parameter);
+            break;
+        case GATE_ROTATION_X:
+            gate_rotation_x(state, gate->qubit1, gate->parameter);
+            break;
+        case GATE_ROTATION_Y:
+            gate_rotation_y(state, gate->qubit1, gate->parameter);
+            break;
+        case GATE_ROTATION_Z:
+            gate_rotation_z(state, gate->qubit1, gate->parameter);
+            break;
+        case GATE_CNOT:
+            gate_cnot(state, gate->qubit1, gate->qubit2);
+            break;
+        case GATE_CZ:
+            gate_cz(state, gate->qubit1, gate->qubit2);
+            break;
+        case GATE_SWAP:
+            gate_swap(state, gate->qubit1, gate->qubit2);
+            break;
+        case GATE_MEASURE:
+            {
+                int result = quantum_state_measure_qubit(state, gate->qubit1);
+                if (measurement) *measurement = result;
+            }
+            break;
+        case GATE_MEASURE_ALL:
+            {
+                int result = quantum_state_measure_all(state);
+                if (measurement) *measurement = result;
+            }
+            break;
+        case GATE_QFT:
+            gate_qft(state, gate->qubit1, gate->qubit2);
+            break;
+        case GATE_IQFT:
+            gate_inverse_qft(state, gate->qubit1, gate->qubit2);
+            break;
+        case GATE_ORACLE:
+            gate_oracle(state, gate->oracle);
+            break;
+        case GATE_CONTROLLED_PHASE:
+            gate_controlled_phase(state, gate->qubit1, gate->qubit2, gate->parameter);
+            break;
+        default:
+            fprintf(stderr, "Error: Unknown gate type\n");
+            return 0;
+    }
+    
+    return 1;
+}
+
+int quantum_circuit_apply_gate(const QuantumGate *gate, QuantumState *state, int *measurement) {
+    ExecutionProfile *profile = quantum_profile_active();
+    if (!profile) return apply_gate_kernel(gate, state, measurement);
+    
+    double start = quantum_profile_seconds();
+    int applied = apply_gate_kernel(gate, state, measurement);
+    if (applied) quantum_profile_record(profile, gate, state->num_qubits, quantum_profile_seconds() - start);
+    return applied;
+}
+
 int quantum_circuit_execute(const QuantumCircuit *circuit, QuantumState *state) {
     if (!circuit || !state) {
         fprintf(stderr, "Error: Null circuit or state\n");
@@ -145,60 +336,20 @@ int quantum_circuit_execute(const QuantumCircuit *circuit, QuantumState *state)
     
     for (int i = 0; i < circuit->num_gates; i++) {
         const QuantumGate *gate = &circuit->gates[i];
+        int result = 0;
         
-        switch (gate->type) {
-            case GATE_PAULI_X:
-                gate_pauli_x(state, gate->qubit1);
-                break;
-            case GATE_PAULI_Y:
-                gate_pauli_y(state, gate->qubit1);
-                break;
-            case GATE_PAULI_Z:
-                gate_pauli_z(state, gate->qubit1);
-                break;
-            case GATE_HADAMARD:
-                gate_hadamard(state, gate->qubit1);
-                break;
-            case GATE_PHASE:
-                gate_phase(state, gate->qubit1, gate->parameter);
-                break;
-            case GATE_ROTATION_X:
-                gate_rotation_x(state, gate->qubit1, gate->parameter);
-                break;
-            case GATE_ROTATION_Y:
-                gate_rotation_y(state, gate->qubit1, gate->parameter);
-                break;
-            case GATE_ROTATION_Z:
-                gate_rotation_z(state, gate->qubit1, gate->parameter);
-                break;
-            case GATE_CNOT:
-                gate_cnot(state, gate->qubit1, gate->qubit2);
-                break;
-            case GATE_CZ:
-                gate_cz(state, gate->qubit1, gate->qubit2);
-                break;
-            case GATE_SWAP:
-                gate_swap(state, gate->qubit1, gate->qubit2);
-                break;
-            case GATE_MEASURE:
-                {
-                    int result = quantum_state_measure_qubit(state, gate->qubit1);
-                    printf("Measured qubit %d: %d\n", gate->qubit1, result);
-                }
-                break;
-            case GATE_MEASURE_ALL:
-                {
-                    int result = quantum_state_measure_all(state);
-                    printf("Measured all qubits: %d (binary: ", result);
-                    for (int j = state->num_qubits - 1; j >= 0; j--) {
-                        printf("%d", (result >> j) & 1);
-                    }
-                    printf(")\n");
-                }
-                break;
-            default:
-                fprintf(stderr, "Error: Unknown gate type\n");
-                return 0;
+        if (!quantum_circuit_apply_gate(gate, state, &result)) {
+            return 0;
+        }
+        
+        if (gate->type == GATE_MEASURE) {
+            printf("Measured qubit %d: %d\n", gate->qubit1, result);
+        } else if (gate->type == GATE_MEASURE_ALL) {
+            printf("Measured all qubits: %d (binary: ", result);
+            for (int j = state->num_qubits - 1; j >= 0; j--) {
+                printf("%d", (result >> j) & 1);
+            }
+            printf(")\n");
         }
     }
     
@@ -220,10 +371,391 @@ const char* gate_type_to_string(GateType type) {
         case GATE_SWAP: return "SWAP";
         case GATE_MEASURE: return "M";
         case GATE_MEASURE_ALL: return "M_ALL";
+        case GATE_QFT: return "QFT";
+        case GATE_IQFT: return "IQFT";
+        case GATE_ORACLE: return "ORACLE";
+        case GATE_CONTROLLED_PHASE: return "CP";
         default: return "UNKNOWN";
     }
 }
 
+int quantum_circuit_is_single_qubit_unitary(GateType type) {
+    switch (type) {
+        case GATE_PAULI_X:
+        case GATE_PAULI_Y:
+        case GATE_PAULI_Z:
+        case GATE_HADAMARD:
+        case GATE_PHASE:
+        case GATE_ROTATION_X:
+        case GATE_ROTATION_Y:
+        case GATE_ROTATION_Z:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* Bitmask of the qubits a gate reads or writes */
+unsigned int quantum_circuit_gate_qubits(const QuantumGate *gate, int num_qubits) {
+    unsigned int all = (1u << num_qubits) - 1;
+    
+    switch (gate->type) {
+        case GATE_MEASURE_ALL:
+            return all;
+        case GATE_QFT:
+        case GATE_IQFT:
+            return ((1u << (gate->qubit2 + 1)) - 1) & ~((1u << gate->qubit1) - 1);
+        case GATE_ORACLE:
+            if (!gate->oracle) return all;
+            return (((1u << gate->oracle->input_width) - 1) << gate->oracle->input_qubit) |
+                   (((1u << gate->oracle->output_width) - 1) << gate->oracle->output_qubit);
+        default:
+            return (1u << gate->qubit1) | (gate->qubit2 >= 0 ? (1u << gate->qubit2) : 0);
+    }
+}
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+#define WRITER_BATCH 256
+
+struct CircuitFileWriter {
+    FILE *file;
+    char *path;
+    CircuitFileHeader header;
+    uint64_t checksum;
+    int failed;
+    char parameter_names[MAX_PARAMETERS][MAX_PARAMETER_NAME];
+};
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t length) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+CircuitFileWriter* quantum_circuit_writer_open(const char *path, int num_qubits, const char *description) {
+    if (!path || num_qubits < 1 || num_qubits > MAX_MAPPED_QUBITS) {
+        fprintf(stderr, "Error: Invalid circuit file path or qubit count\n");
+        return NULL;
+    }
+    
+    CircuitFileWriter *writer = calloc(1, sizeof(CircuitFileWriter));
+    if (!writer || !(writer->path = malloc(strlen(path) + 1))) {
+        fprintf(stderr, "Error: Failed to allocate memory for circuit writer\n");
+        free(writer);
+        return NULL;
+    }
+    strcpy(writer->path, path);
+    
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        fprintf(stderr, "Error: Cannot create circuit file %s\n", path);
+        free(writer->path);
+        free(writer);
+        return NULL;
+    }
+    
+    CircuitFileHeader *header = &writer->header;
+    memcpy(header->magic, CIRCUIT_FILE_MAGIC, sizeof(header->magic));
+    header->version = CIRCUIT_FILE_VERSION;
+    header->num_qubits = (uint32_t)num_qubits;
+    header->record_size = sizeof(CircuitFileRecord);
+    strncpy(header->description, description ? description : "Quantum Circuit", sizeof(header->description) - 1);
+    writer->checksum = FNV_OFFSET_BASIS;
+    
+    /* Placeholder, rewritten with the final counts and checksum on close */
+    if (fwrite(header, sizeof(CircuitFileHeader), 1, writer->file) != 1) writer->failed = 1;
+    return writer;
+}
+
+int quantum_circuit_writer_append(CircuitFileWriter *writer, const QuantumCircuit *circuit) {
+    if (!writer || !circuit) {
+        fprintf(stderr, "Error: Null circuit writer or circuit\n");
+        return 0;
+    }
+    if (writer->failed) return 0;
+    
+    if ((uint32_t)circuit->num_qubits != writer->header.num_qubits) {
+        fprintf(stderr, "Error: Circuit and file have different numbers of qubits\n");
+        writer->failed = 1;
+        return 0;
+    }
+    
+    /* The first parameter table seen is adopted; later chunks must match it */
+    if (circuit->num_parameters > 0) {
+        size_t table = circuit->num_parameters * sizeof(writer->parameter_names[0]);
+        if (writer->header.num_parameters == 0) {
+            memcpy(writer->parameter_names, circuit->parameter_names, table);
+            writer->header.num_parameters = circuit->num_parameters;
+        } else if (writer->header.num_parameters != (uint32_t)circuit->num_parameters ||
+                   memcmp(writer->parameter_names, circuit->parameter_names, table) != 0) {
+            fprintf(stderr, "Error: Circuit parameters differ from the file's parameter table\n");
+            writer->failed = 1;
+            return 0;
+        }
+    }
+    
+    CircuitFileRecord records[WRITER_BATCH];
+    for (int start = 0; start < circuit->num_gates; start += WRITER_BATCH) {
+        int count = circuit->num_gates - start < WRITER_BATCH ? circuit->num_gates - start : WRITER_BATCH;
+        
+        for (int i = 0; i < count; i++) {
+            const QuantumGate *gate = &circuit->gates[start + i];
+            if (gate->type == GATE_ORACLE) {
+                fprintf(stderr, "Error: Oracle gates cannot be written to a circuit file\n");
+                writer->failed = 1;
+                return 0;
+            }
+            
+            CircuitFileRecord *record = &records[i];
+            memset(record, 0, sizeof(CircuitFileRecord));
+            record->type = (uint32_t)gate->type;
+            record->qubit1 = gate->qubit1;
+            record->qubit2 = gate->qubit2;
+            record->parameter_index = gate->parameter_index;
+            record->parameter = gate->parameter;
+        }
+        
+        writer->checksum = fnv1a(writer->checksum, records, count * sizeof(CircuitFileRecord));
+        if (fwrite(records, sizeof(CircuitFileRecord), count, writer->file) != (size_t)count) {
+            fprintf(stderr, "Error: Failed to write circuit file %s\n", writer->path);
+            writer->failed = 1;
+            return 0;
+        }
+        writer->header.num_gates += count;
+    }
+    
+    return 1;
+}
+
+int quantum_circuit_writer_close(CircuitFileWriter *writer) {
+    if (!writer) return 0;
+    
+    int success = !writer->failed;
+    if (success) {
+        size_t table = writer->header.num_parameters * sizeof(writer->parameter_names[0]);
+        writer->checksum = fnv1a(writer->checksum, writer->parameter_names, table);
+        writer->header.checksum = writer->checksum;
+        
+        success = fwrite(writer->parameter_names, 1, table, writer->file) == table &&
+                  fseek(writer->file, 0, SEEK_SET) == 0 &&
+                  fwrite(&writer->header, sizeof(CircuitFileHeader), 1, writer->file) == 1;
+    }
+    if (fclose(writer->file) != 0) success = 0;
+    
+    if (!success) {
+        fprintf(stderr, "Error: Circuit file %s was not written\n", writer->path);
+        remove(writer->path);
+    }
+    free(writer->path);
+    free(writer);
+    return success;
+}
+
+int quantum_circuit_save_binary(const QuantumCircuit *circuit, const char *path) {
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return 0;
+    }
+    
+    CircuitFileWriter *writer = quantum_circuit_writer_open(path, circuit->num_qubits, circuit->description);
+    if (!writer) return 0;
+    
+    quantum_circuit_writer_append(writer, circuit);
+    return quantum_circuit_writer_close(writer);
+}
+
+static int validate_record(const CircuitFileHeader *header, const CircuitFileRecord *record, uint64_t index) {
+    int n = (int)header->num_qubits;
+    int valid = record->type < NUM_GATE_TYPES && record->type != GATE_ORACLE &&
+                record->qubit1 >= 0 && record->qubit1 < n &&
+                record->qubit2 >= -1 && record->qubit2 < n &&
+                record->parameter_index >= -1 && record->parameter_index < (int32_t)header->num_parameters;
+    
+    if (valid && record->parameter_index >= 0) {
+        valid = quantum_circuit_is_parameterisable((GateType)record->type);
+    }
+    if (valid) {
+        switch ((GateType)record->type) {
+            case GATE_CNOT:
+            case GATE_CZ:
+            case GATE_SWAP:
+            case GATE_CONTROLLED_PHASE:
+                valid = record->qubit2 >= 0 && record->qubit1 != record->qubit2;
+                break;
+            case GATE_QFT:
+            case GATE_IQFT:
+                valid = record->qubit2 >= record->qubit1;
+                break;
+            default:
+                break;
+        }
+    }
+    
+    if (!valid) {
+        fprintf(stderr, "Error: Circuit file record %llu is invalid\n", (unsigned long long)index);
+    }
+    return valid;
+}
+
+/* Checks a whole file image (at least a header long) and points view into it */
+static int validate_image(const void *base, size_t length, const char *name, MappedCircuit *view) {
+    const CircuitFileHeader *header = base;
+    const CircuitFileRecord *records = (const CircuitFileRecord *)(header + 1);
+    int valid = memcmp(header->magic, CIRCUIT_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+                header->version == CIRCUIT_FILE_VERSION &&
+                header->record_size == sizeof(CircuitFileRecord) &&
+                header->num_qubits >= 1 && header->num_qubits <= MAX_MAPPED_QUBITS &&
+                header->num_parameters <= MAX_PARAMETERS &&
+                header->num_gates <= (length - sizeof(CircuitFileHeader)) / sizeof(CircuitFileRecord) &&
+                length == sizeof(CircuitFileHeader) + header->num_gates * sizeof(CircuitFileRecord) +
+                          header->num_parameters * (size_t)MAX_PARAMETER_NAME;
+    
+    if (!valid) {
+        fprintf(stderr, "Error: %s is not a valid circuit file\n", name);
+    } else if (fnv1a(FNV_OFFSET_BASIS, records, length - sizeof(CircuitFileHeader)) != header->checksum) {
+        fprintf(stderr, "Error: Circuit file %s failed its checksum\n", name);
+        valid = 0;
+    }
+    for (uint64_t i = 0; valid && i < header->num_gates; i++) {
+        valid = validate_record(header, &records[i], i);
+    }
+    if (!valid) return 0;
+    
+    view->base = (void *)base;
+    view->length = length;
+    view->header = header;
+    view->records = records;
+    view->parameter_names = (const char (*)[MAX_PARAMETER_NAME])(records + header->num_gates);
+    return 1;
+}
+
+MappedCircuit* quantum_circuit_map_binary(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open circuit file %s\n", path);
+        return NULL;
+    }
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(CircuitFileHeader)) {
+        fprintf(stderr, "Error: %s is not a circuit file\n", path);
+        close(fd);
+        return NULL;
+    }
+    
+    size_t length = (size_t)info.st_size;
+    void *base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map circuit file %s\n", path);
+        return NULL;
+    }
+    madvise(base, length, MADV_SEQUENTIAL);
+    
+    MappedCircuit view;
+    int valid = validate_image(base, length, path, &view);
+    MappedCircuit *mapped = valid ? malloc(sizeof(MappedCircuit)) : NULL;
+    if (!mapped) {
+        if (valid) fprintf(stderr, "Error: Failed to allocate memory for mapped circuit\n");
+        munmap(base, length);
+        return NULL;
+    }
+    
+    *mapped = view;
+    return mapped;
+}
+
+int quantum_circuit_view_binary(const void *data, size_t length, MappedCircuit *view) {
+    if (!data || !view || length < sizeof(CircuitFileHeader)) {
+        fprintf(stderr, "Error: Circuit image is too short\n");
+        return 0;
+    }
+    return validate_image(data, length, "<memory>", view);
+}
+
+void quantum_circuit_unmap_binary(MappedCircuit *mapped) {
+    if (mapped) {
+        munmap(mapped->base, mapped->length);
+        free(mapped);
+    }
+}
+
+int quantum_circuit_execute_mapped(const MappedCircuit *mapped, QuantumState *state, const double *parameters) {
+    if (!mapped || !state) {
+        fprintf(stderr, "Error: Null mapped circuit or state\n");
+        return 0;
+    }
+    if ((uint32_t)state->num_qubits != mapped->header->num_qubits) {
+        fprintf(stderr, "Error: Circuit and state have different numbers of qubits\n");
+        return 0;
+    }
+    if (mapped->header->num_parameters > 0 && !parameters) {
+        fprintf(stderr, "Error: Circuit file needs %u parameter values\n", mapped->header->num_parameters);
+        return 0;
+    }
+    
+    /* Records were validated when mapped, so they are applied straight from the file */
+    uint64_t num_gates = mapped->header->num_gates;
+    for (uint64_t i = 0; i < num_gates; i++) {
+        const CircuitFileRecord *record = &mapped->records[i];
+        QuantumGate gate;
+        gate.type = (GateType)record->type;
+        gate.qubit1 = record->qubit1;
+        gate.qubit2 = record->qubit2;
+        gate.parameter_index = record->parameter_index;
+        gate.parameter = record->parameter_index >= 0 ? parameters[record->parameter_index] : record->parameter;
+        gate.oracle = NULL;
+        
+        if (!quantum_circuit_apply_gate(&gate, state, NULL)) return 0;
+    }
+    return 1;
+}
+
+QuantumCircuit* quantum_circuit_load_binary(const char *path) {
+    MappedCircuit *mapped = quantum_circuit_map_binary(path);
+    if (!mapped) return NULL;
+    
+    const CircuitFileHeader *header = mapped->header;
+    if (header->num_gates > MAX_GATES) {
+        fprintf(stderr, "Error: Circuit file has %llu gates, more than %d; map it instead\n",
+                (unsigned long long)header->num_gates, MAX_GATES);
+        quantum_circuit_unmap_binary(mapped);
+        return NULL;
+    }
+    
+    char description[sizeof(header->description) + 1];
+    memcpy(description, header->description, sizeof(header->description));
+    description[sizeof(header->description)] = '\0';
+    
+    QuantumCircuit *circuit = quantum_circuit_create((int)header->num_qubits, description);
+    if (circuit) {
+        circuit->num_parameters = (int)header->num_parameters;
+        memcpy(circuit->parameter_names, mapped->parameter_names,
+               header->num_parameters * sizeof(circuit->parameter_names[0]));
+        for (int p = 0; p < circuit->num_parameters; p++) {
+            circuit->parameter_names[p][MAX_PARAMETER_NAME - 1] = '\0';
+        }
+        
+        circuit->num_gates = (int)header->num_gates;
+        for (int i = 0; i < circuit->num_gates; i++) {
+            const CircuitFileRecord *record = &mapped->records[i];
+            QuantumGate *gate = &circuit->gates[i];
+            gate->type = (GateType)record->type;
+            gate->qubit1 = record->qubit1;
+            gate->qubit2 = record->qubit2;
+            gate->parameter = record->parameter;
+            gate->parameter_index = record->parameter_index;
+            gate->oracle = NULL;
+        }
+    }
+    
+    quantum_circuit_unmap_binary(mapped);
+    return circuit;
+}
+
 void quantum_circuit_print(const QuantumCircuit *circuit) {
     if (!circuit) return;
     
@@ -234,13 +766,21 @@ void quantum_circuit_print(const QuantumCircuit *circuit) {
         const QuantumGate *gate = &circuit->gates[i];
         printf("Gate %d: %s", i + 1, gate_type_to_string(gate->type));
         
-        if (gate->qubit2 == -1) {
+        if (gate->type == GATE_QFT || gate->type == GATE_IQFT) {
+            printf(" on qubits %d..%d", gate->qubit1, gate->qubit2);
+        } else if (gate->type == GATE_ORACLE) {
+            printf(" on qubits %d..%d -> %d..%d",
+                   gate->oracle->input_qubit, gate->oracle->input_qubit + gate->oracle->input_width - 1,
+                   gate->oracle->output_qubit, gate->oracle->output_qubit + gate->oracle->output_width - 1);
+        } else if (gate->qubit2 == -1) {
             printf(" on qubit %d", gate->qubit1);
         } else {
             printf(" on qubits %d,%d", gate->qubit1, gate->qubit2);
         }
         
-        if (gate->parameter != 0.0) {
+        if (gate->parameter_index >= 0) {
+            printf(" (parameter: %s)", circuit->parameter_names[gate->parameter_index]);
+        } else if (gate->parameter != 0.0) {
             printf(" (parameter: %.4f)", gate->parameter);
         }
         
@@ -252,5 +792,6 @@ void quantum_circuit_print(const QuantumCircuit *circuit) {
 void quantum_circuit_clear(QuantumCircuit *circuit) {
     if (circuit) {
         circuit->num_gates = 0;
+        circuit->num_parameters = 0;
     }
 }
\ No newline at end of file
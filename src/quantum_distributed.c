@@ -0,0 +1,505 @@
+#include "quantum_distributed.h"
+#include "quantum_layout.h"
+#include "quantum_gates.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Define M_PI if not available */
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+typedef struct Transport Transport;
+
+/* Pairwise exchange of equal-sized buffers. Every rank calls it for every
+ * global swap; a negative partner takes part without exchanging data. */
+struct Transport {
+    int rank;
+    int (*exchange)(Transport *transport, int partner, const void *send, void *receive, size_t bytes);
+    pthread_barrier_t *barrier;                 /* Shared memory */
+    char *mailboxes;
+    size_t mailbox_bytes;
+    int peers[DISTRIBUTED_MAX_PROCESSES];       /* Sockets, -1 for self */
+};
+
+typedef struct {
+    int exchanges;
+    long long bytes_sent;
+} RankStats;
+
+typedef struct {
+    Transport *transport;
+    Complex *slice;
+    Complex *buffer;            /* One slice of exchange scratch */
+    int local;                  /* Qubits addressed within a slice */
+    size_t slice_states;
+    QuantumLayout layout;
+    RankStats *stats;
+} Rank;
+
+// =============================================================================
+// TRANSPORTS
+// =============================================================================
+
+static int shared_exchange(Transport *t, int partner, const void *send, void *receive, size_t bytes) {
+    if (partner >= 0) memcpy(t->mailboxes + t->rank * t->mailbox_bytes, send, bytes);
+    pthread_barrier_wait(t->barrier);
+    if (partner >= 0) memcpy(receive, t->mailboxes + partner * t->mailbox_bytes, bytes);
+    pthread_barrier_wait(t->barrier);
+    return 1;
+}
+
+static int send_full(int fd, const void *data, size_t length) {
+    const char *bytes = data;
+    while (length > 0) {
+        ssize_t count = send(fd, bytes, length, MSG_NOSIGNAL);
+        if (count <= 0) return 0;
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return 1;
+}
+
+static int receive_full(int fd, void *data, size_t length) {
+    char *bytes = data;
+    while (length > 0) {
+        ssize_t count = recv(fd, bytes, length, 0);
+        if (count <= 0) return 0;
+        bytes += count;
+        length -= (size_t)count;
+    }
+    return 1;
+}
+
+/* The lower rank sends first, so a pair never blocks on two full socket buffers */
+static int socket_exchange(Transport *t, int partner, const void *send, void *receive, size_t bytes) {
+    if (partner < 0) return 1;
+
+    int fd = t->peers[partner];
+    if (t->rank < partner) {
+        return send_full(fd, send, bytes) && receive_full(fd, receive, bytes);
+    }
+    return receive_full(fd, receive, bytes) && send_full(fd, send, bytes);
+}
+
+// =============================================================================
+// RANK EXECUTION
+// =============================================================================
+
+static int rank_exchange(Rank *r, int partner, const void *send, void *receive, size_t bytes) {
+    r->stats->exchanges++;
+    if (partner >= 0) r->stats->bytes_sent += (long long)bytes;
+    return r->transport->exchange(r->transport, partner, send, receive, bytes);
+}
+
+/* Local position `local` trades places with global position `global`: the half
+ * of the slice whose local bit differs from this rank's global bit is swapped
+ * with the matching half on the partner rank */
+static int swap_local_global(Rank *r, int local, int global) {
+    int bit = global - r->local;
+    int partner = r->transport->rank ^ (1 << bit);
+    int high = (r->transport->rank >> bit) & 1;
+    size_t local_mask = (size_t)1 << local;
+    long long half = (long long)(r->slice_states / 2);
+    Complex *send = r->buffer;
+    Complex *receive = r->buffer + half;
+
+    #pragma omp parallel for
+    for (long long t = 0; t < half; t++) {
+        size_t k = (((size_t)t >> local) << (local + 1)) | ((size_t)t & (local_mask - 1));
+        send[t] = r->slice[high ? k : (k | local_mask)];
+    }
+
+    if (!rank_exchange(r, partner, send, receive, half * sizeof(Complex))) return 0;
+
+    #pragma omp parallel for
+    for (long long t = 0; t < half; t++) {
+        size_t k = (((size_t)t >> local) << (local + 1)) | ((size_t)t & (local_mask - 1));
+        r->slice[high ? k : (k | local_mask)] = receive[t];
+    }
+    return 1;
+}
+
+/* Two global positions: ranks whose bits differ trade whole slices */
+static int swap_global_global(Rank *r, int global1, int global2) {
+    int bit1 = global1 - r->local, bit2 = global2 - r->local;
+    int rank = r->transport->rank;
+    int partner = (((rank >> bit1) ^ (rank >> bit2)) & 1) ? rank ^ (1 << bit1) ^ (1 << bit2) : -1;
+    size_t bytes = r->slice_states * sizeof(Complex);
+
+    if (!rank_exchange(r, partner, r->slice, r->buffer, bytes)) return 0;
+    if (partner >= 0) memcpy(r->slice, r->buffer, bytes);
+    return 1;
+}
+
+/* Layout callback for positions p1 < p2 */
+static int physical_swap(void *context, int p1, int p2) {
+    Rank *r = context;
+
+    if (p2 < r->local) {
+        QuantumState view = {r->local, (int)r->slice_states, r->slice, QUANTUM_STORAGE_HEAP,
+                          QUANTUM_FORM_DENSE, NULL, NULL};
+        gate_swap(&view, p1, p2);
+        return 1;
+    }
+    if (p1 < r->local) return swap_local_global(r, p1, p2);
+    return swap_global_global(r, p1, p2);
+}
+
+static int run_rank(Rank *r, const QuantumGate *gates, int num_gates, int num_qubits) {
+    QuantumState view = {r->local, (int)r->slice_states, r->slice, QUANTUM_STORAGE_HEAP,
+                          QUANTUM_FORM_DENSE, NULL, NULL};
+    QuantumLayout *layout = &r->layout;
+
+    /* Every rank makes the same layout decisions, so their exchanges pair up */
+    quantum_layout_init(layout, num_qubits, r->local, physical_swap, r);
+    for (int i = 0; i < num_gates; i++) {
+        QuantumGate gate = gates[i];
+        if (!quantum_layout_is_local(layout, &gate) &&
+            !quantum_layout_localise(layout, gates, num_gates, i)) {
+            return 0;
+        }
+
+        gate.qubit1 = layout->physical[gate.qubit1];
+        if (gate.qubit2 >= 0) gate.qubit2 = layout->physical[gate.qubit2];
+        if (!quantum_circuit_apply_gate(&gate, &view, NULL)) return 0;
+    }
+    return quantum_layout_restore(layout);
+}
+
+// =============================================================================
+// CIRCUIT EXPANSION
+// =============================================================================
+
+static void append_gate(QuantumGate *gates, int *count, GateType type, int qubit1, int qubit2, double parameter) {
+    QuantumGate *gate = &gates[(*count)++];
+    gate->type = type;
+    gate->qubit1 = qubit1;
+    gate->qubit2 = qubit2;
+    gate->parameter = parameter;
+    gate->parameter_index = -1;
+    gate->oracle = NULL;
+}
+
+/* QFT over first..last (last most significant) as H and controlled phases,
+ * then a bit reversal; the inverse runs the same gates backwards, conjugated */
+static void append_qft(QuantumGate *gates, int *count, int first, int last, int inverse) {
+    int start = *count;
+
+    for (int j = last; j >= first; j--) {
+        append_gate(gates, count, GATE_HADAMARD, j, -1, 0.0);
+        for (int i = j - 1; i >= first; i--) {
+            append_gate(gates, count, GATE_CONTROLLED_PHASE, i, j, M_PI / (double)(1 << (j - i)));
+        }
+    }
+    for (int k = 0; first + k < last - k; k++) {
+        append_gate(gates, count, GATE_SWAP, first + k, last - k, 0.0);
+    }
+
+    if (inverse) {
+        for (int a = start, b = *count - 1; a < b; a++, b--) {
+            QuantumGate temp = gates[a];
+            gates[a] = gates[b];
+            gates[b] = temp;
+        }
+        for (int k = start; k < *count; k++) {
+            gates[k].parameter = -gates[k].parameter;
+        }
+    }
+}
+
+static QuantumGate* expand_circuit(const QuantumCircuit *circuit, int *num_gates) {
+    size_t capacity = 0;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        const QuantumGate *gate = &circuit->gates[i];
+        int width = gate->qubit2 - gate->qubit1 + 1;
+
+        switch (gate->type) {
+            case GATE_MEASURE:
+            case GATE_MEASURE_ALL:
+            case GATE_ORACLE:
+                fprintf(stderr, "Error: Gate %d (%s) is not supported by the distributed backend\n",
+                        i, gate_type_to_string(gate->type));
+                return NULL;
+            case GATE_QFT:
+            case GATE_IQFT:
+                if (gate->qubit1 < 0 || width < 1 || gate->qubit2 >= circuit->num_qubits) {
+                    fprintf(stderr, "Error: Gate %d has an invalid QFT range\n", i);
+                    return NULL;
+                }
+                capacity += (size_t)width * (width + 1) / 2 + width / 2;
+                break;
+            default:
+                if (gate->qubit1 < 0 || gate->qubit1 >= circuit->num_qubits ||
+                    gate->qubit2 < -1 || gate->qubit2 >= circuit->num_qubits) {
+                    fprintf(stderr, "Error: Gate %d acts on a qubit out of range [0, %d)\n", i, circuit->num_qubits);
+                    return NULL;
+                }
+                capacity++;
+                break;
+        }
+    }
+
+    QuantumGate *gates = malloc((capacity + 1) * sizeof(QuantumGate));
+    if (!gates) {
+        fprintf(stderr, "Error: Failed to allocate memory for expanded circuit\n");
+        return NULL;
+    }
+
+    int count = 0;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        const QuantumGate *gate = &circuit->gates[i];
+        if (gate->type == GATE_QFT || gate->type == GATE_IQFT) {
+            append_qft(gates, &count, gate->qubit1, gate->qubit2, gate->type == GATE_IQFT);
+        } else {
+            gates[count++] = *gate;
+        }
+    }
+
+    *num_gates = count;
+    return gates;
+}
+
+// =============================================================================
+// PROCESS MANAGEMENT
+// =============================================================================
+
+static void close_sockets(int sockets[][DISTRIBUTED_MAX_PROCESSES], int num_processes, int keep_rank) {
+    for (int i = 0; i < num_processes; i++) {
+        for (int j = 0; j < num_processes; j++) {
+            if (i != keep_rank && sockets[i][j] >= 0) {
+                close(sockets[i][j]);
+                sockets[i][j] = -1;
+            }
+        }
+    }
+}
+
+static void rank_main(int rank, const DistributedOptions *options, const QuantumGate *gates, int num_gates,
+                      const QuantumState *state, Complex *shared_slices, Transport *transport,
+                      int parent_socket, RankStats *stats) {
+    size_t slice_states = (size_t)state->num_states / options->num_processes;
+    size_t slice_bytes = slice_states * sizeof(Complex);
+
+#ifdef _OPENMP
+    /* The processes already fill the machine */
+    omp_set_num_threads(1);
+#endif
+
+    Rank r;
+    memset(&r, 0, sizeof(r));
+    r.transport = transport;
+    r.local = state->num_qubits;
+    for (int p = options->num_processes; p > 1; p >>= 1) r.local--;
+    r.slice_states = slice_states;
+    r.stats = &stats[rank];
+    r.buffer = malloc(slice_bytes);
+
+    /* Socket ranks keep a private slice, copied from the state inherited over fork */
+    if (shared_slices) {
+        r.slice = shared_slices + rank * slice_states;
+    } else if ((r.slice = malloc(slice_bytes)) != NULL) {
+        memcpy(r.slice, state->amplitudes + rank * slice_states, slice_bytes);
+    }
+
+    int success = r.buffer && r.slice && run_rank(&r, gates, num_gates, state->num_qubits);
+    if (success && parent_socket >= 0) success = send_full(parent_socket, r.slice, slice_bytes);
+
+    if (!success) fprintf(stderr, "Error: Distributed rank %d failed\n", rank);
+    _exit(success ? 0 : 1);
+}
+
+/* Reaps exactly the ranks' processes, leaving any other children of the host
+ * to their owner. Ranks are polled rather than waited on in order, since a
+ * rank that fails can leave its partners blocked until they are killed.
+ * Returns 1 when success held and every rank exited with status 0. */
+static int wait_for_ranks(const pid_t *pids, int count, int success) {
+    int reaped[DISTRIBUTED_MAX_PROCESSES] = {0};
+    int remaining = count;
+
+    while (remaining > 0) {
+        int progressed = 0;
+        for (int i = 0; i < count; i++) {
+            if (reaped[i]) continue;
+
+            int status = 0;
+            pid_t result = waitpid(pids[i], &status, WNOHANG);
+            if (result == 0 || (result < 0 && errno == EINTR)) continue;
+
+            reaped[i] = 1;
+            remaining--;
+            progressed = 1;
+            if (result < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                if (success) {
+                    for (int j = 0; j < count; j++) {
+                        if (!reaped[j]) kill(pids[j], SIGKILL);
+                    }
+                }
+                success = 0;
+            }
+        }
+        if (!progressed && remaining > 0) {
+            struct timespec pause = {0, 1000000};  /* 1 ms */
+            nanosleep(&pause, NULL);
+        }
+    }
+    return success;
+}
+
+int quantum_distributed_execute(const QuantumCircuit *circuit, QuantumState *state,
+                                const DistributedOptions *options, DistributedStats *stats) {
+    if (!circuit || !state || !options) {
+        fprintf(stderr, "Error: Null circuit, state or options\n");
+        return 0;
+    }
+    if (circuit->num_qubits != state->num_qubits) {
+        fprintf(stderr, "Error: Circuit and state have different numbers of qubits\n");
+        return 0;
+    }
+
+    int P = options->num_processes;
+    int global_qubits = 0;
+    while ((1 << global_qubits) < P) global_qubits++;
+    if (P < 1 || P > DISTRIBUTED_MAX_PROCESSES || (1 << global_qubits) != P ||
+        state->num_qubits - global_qubits < 2) {
+        fprintf(stderr, "Error: Process count must be a power of two up to %d leaving at least 2 local qubits\n",
+                DISTRIBUTED_MAX_PROCESSES);
+        return 0;
+    }
+
+    int num_gates;
+    QuantumGate *gates = expand_circuit(circuit, &num_gates);
+    if (!gates) return 0;
+    quantum_state_materialise(state);
+
+    /* Shared block: rank stats, barrier, then slices and mailboxes for shared memory */
+    int use_shared = options->transport == DISTRIBUTED_TRANSPORT_SHARED_MEMORY;
+    size_t state_bytes = (size_t)state->num_states * sizeof(Complex);
+    size_t header_bytes = (P * sizeof(RankStats) + sizeof(pthread_barrier_t) + 63) / 64 * 64;
+    size_t shared_bytes = header_bytes + (use_shared ? 2 * state_bytes : 0);
+    char *shared = mmap(NULL, shared_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map shared memory for distributed execution\n");
+        free(gates);
+        return 0;
+    }
+
+    RankStats *rank_stats = (RankStats *)shared;
+    memset(rank_stats, 0, P * sizeof(RankStats));
+
+    Transport transport;
+    memset(&transport, 0, sizeof(transport));
+    Complex *shared_slices = NULL;
+    int sockets[DISTRIBUTED_MAX_PROCESSES][DISTRIBUTED_MAX_PROCESSES];
+    int parent_sockets[DISTRIBUTED_MAX_PROCESSES][2];
+    int success = 1;
+
+    for (int i = 0; i < P; i++) {
+        parent_sockets[i][0] = parent_sockets[i][1] = -1;
+        for (int j = 0; j < P; j++) sockets[i][j] = -1;
+    }
+
+    if (use_shared) {
+        pthread_barrierattr_t attributes;
+        pthread_barrier_t *barrier = (pthread_barrier_t *)(shared + P * sizeof(RankStats));
+        pthread_barrierattr_init(&attributes);
+        pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+        success = pthread_barrier_init(barrier, &attributes, (unsigned)P) == 0;
+        pthread_barrierattr_destroy(&attributes);
+        if (success) transport.barrier = barrier;
+
+        shared_slices = (Complex *)(shared + header_bytes);
+        transport.mailboxes = shared + header_bytes + state_bytes;
+        transport.mailbox_bytes = state_bytes / P;
+        transport.exchange = shared_exchange;
+        memcpy(shared_slices, state->amplitudes, state_bytes);
+    } else {
+        transport.exchange = socket_exchange;
+        for (int i = 0; i < P && success; i++) {
+            success = socketpair(AF_UNIX, SOCK_STREAM, 0, parent_sockets[i]) == 0;
+            for (int j = i + 1; j < P && success; j++) {
+                int pair[2];
+                success = socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0;
+                if (success) {
+                    sockets[i][j] = pair[0];
+                    sockets[j][i] = pair[1];
+                }
+            }
+        }
+    }
+    if (!success) fprintf(stderr, "Error: Failed to set up the distributed transport\n");
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fflush(NULL);
+
+    pid_t pids[DISTRIBUTED_MAX_PROCESSES];
+    int started = 0;
+    for (int rank = 0; rank < P && success; rank++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            fprintf(stderr, "Error: Failed to start distributed rank %d\n", rank);
+            success = 0;
+            break;
+        }
+        if (pid == 0) {
+            transport.rank = rank;
+            close_sockets(sockets, P, rank);
+            memcpy(transport.peers, sockets[rank], sizeof(transport.peers));
+            for (int i = 0; i < P; i++) {
+                if (parent_sockets[i][0] >= 0) close(parent_sockets[i][0]);
+                if (i != rank && parent_sockets[i][1] >= 0) close(parent_sockets[i][1]);
+            }
+            rank_main(rank, options, gates, num_gates, state, shared_slices, &transport,
+                      parent_sockets[rank][1], rank_stats);
+        }
+        pids[started++] = pid;
+    }
+
+    close_sockets(sockets, P, -1);
+    for (int i = 0; i < P; i++) {
+        if (parent_sockets[i][1] >= 0) close(parent_sockets[i][1]);
+    }
+
+    /* A rank that cannot start or fails leaves its partners waiting, so stop them all */
+    if (!success) {
+        for (int i = 0; i < started; i++) kill(pids[i], SIGKILL);
+    }
+
+    size_t slice_bytes = state_bytes / P;
+    for (int rank = 0; rank < P && success && !use_shared; rank++) {
+        success = receive_full(parent_sockets[rank][0], (char *)state->amplitudes + rank * slice_bytes, slice_bytes);
+    }
+
+    success = wait_for_ranks(pids, started, success);
+
+    for (int i = 0; i < P; i++) {
+        if (parent_sockets[i][0] >= 0) close(parent_sockets[i][0]);
+    }
+    if (success && use_shared) memcpy(state->amplitudes, shared_slices, state_bytes);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (stats && success) {
+        memset(stats, 0, sizeof(DistributedStats));
+        stats->exchanges = rank_stats[0].exchanges;
+        for (int rank = 0; rank < P; rank++) stats->bytes_exchanged += rank_stats[rank].bytes_sent;
+        stats->seconds = (end.tv_sec - start.tv_sec) + 1e-9 * (end.tv_nsec - start.tv_nsec);
+    }
+
+    if (transport.barrier) pthread_barrier_destroy(transport.barrier);
+    munmap(shared, shared_bytes);
+    free(gates);
+    return success;
+}
@@ -0,0 +1,326 @@
+#include "quantum_executor.h"
+#include "quantum_random.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Jobs dealt to a worker occupy order[begin, end); the owner takes from
+ * begin, thieves cut from end */
+typedef struct {
+    pthread_mutex_t lock;
+    int begin;
+    int end;
+} WorkDeque;
+
+typedef struct {
+    QuantumState *states[MAX_QUBITS + 1];  /* Reused state per qubit count */
+    double *cumulative;
+    size_t cumulative_capacity;
+    QuantumRandom random;
+} ExecutorWorker;
+
+typedef struct {
+    const QuantumCircuit *const *circuits;
+    const ExecutorOptions *options;
+    ExecutorResults *results;
+    int *order;  /* Circuit indices, each worker's slice largest first */
+    WorkDeque *deques;
+    ExecutorWorker *workers;
+    int num_workers;
+} Executor;
+
+typedef struct {
+    double cost;
+    int index;
+} ExecutorJob;
+
+static int compare_cost(const void *a, const void *b) {
+    const ExecutorJob *x = a, *y = b;
+    if (x->cost != y->cost) return x->cost < y->cost ? 1 : -1;
+    return x->index - y->index;
+}
+
+static int circuit_is_valid(const QuantumCircuit *circuit) {
+    return circuit && circuit->num_qubits >= 1 && circuit->num_qubits <= MAX_QUBITS;
+}
+
+// =============================================================================
+// WORK DEQUES
+// =============================================================================
+
+static int deque_take(WorkDeque *deque) {
+    int position = -1;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->begin < deque->end) position = deque->begin++;
+    pthread_mutex_unlock(&deque->lock);
+    return position;
+}
+
+/* Moves the back half of another deque into the empty deque of worker w */
+static int deque_steal(Executor *executor, int w) {
+    for (int k = 1; k < executor->num_workers; k++) {
+        WorkDeque *victim = &executor->deques[(w + k) % executor->num_workers];
+        int begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        int remaining = victim->end - victim->begin;
+        if (remaining > 0) {
+            end = victim->end;
+            begin = end - (remaining + 1) / 2;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end) {
+            WorkDeque *own = &executor->deques[w];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// =============================================================================
+// CIRCUIT JOBS
+// =============================================================================
+
+static QuantumState* worker_state(ExecutorWorker *worker, int num_qubits) {
+    if (!worker->states[num_qubits]) {
+        QuantumState *state = quantum_state_create(num_qubits);
+        if (!state) return NULL;
+        quantum_state_enable_product_form(state);
+        worker->states[num_qubits] = state;
+    }
+    return worker->states[num_qubits];
+}
+
+static int circuit_measures(const QuantumCircuit *circuit) {
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type == GATE_MEASURE || circuit->gates[i].type == GATE_MEASURE_ALL) return 1;
+    }
+    return 0;
+}
+
+/* Draws shots outcomes from the final distribution of an unmeasured circuit */
+static int sample_shots(ExecutorWorker *worker, QuantumState *state, int shots, int *outcomes) {
+    int num_states = state->num_states;
+    if ((size_t)num_states > worker->cumulative_capacity) {
+        double *grown = realloc(worker->cumulative, (size_t)num_states * sizeof(double));
+        if (!grown) return 0;
+        worker->cumulative = grown;
+        worker->cumulative_capacity = (size_t)num_states;
+    }
+    return quantum_state_sample(state, &worker->random, shots, worker->cumulative, outcomes);
+}
+
+static int run_job(Executor *executor, ExecutorWorker *worker, int index) {
+    const QuantumCircuit *circuit = executor->circuits[index];
+    const ExecutorOptions *options = executor->options;
+    ExecutorResults *results = executor->results;
+    int *outcomes = results->outcomes ? results->outcomes + (size_t)index * (size_t)results->shots : NULL;
+
+    if (!circuit_is_valid(circuit)) return 0;
+    QuantumState *state = worker_state(worker, circuit->num_qubits);
+    if (!state) return 0;
+
+    quantum_random_seed(&worker->random, options->seed, (uint64_t)index);
+    int measured = circuit_measures(circuit);
+    int runs = (measured && outcomes) ? results->shots : 1;
+
+    /* Measurements collapse the state part way through, so every shot is a fresh run */
+    for (int run = 0; run < runs; run++) {
+        quantum_state_initialise_zero(state);
+        for (int i = 0; i < circuit->num_gates; i++) {
+            if (!quantum_circuit_apply_gate(&circuit->gates[i], state, NULL)) return 0;
+        }
+        if (measured && outcomes) outcomes[run] = quantum_state_measure_all(state);
+    }
+    if (!measured && outcomes && !sample_shots(worker, state, results->shots, outcomes)) return 0;
+
+    if (results->amplitudes) {
+        quantum_state_materialise(state);
+        memcpy(results->amplitudes + results->state_offsets[index], state->amplitudes,
+               (size_t)state->num_states * sizeof(Complex));
+    }
+    return 1;
+}
+
+static void finish_job(Executor *executor, ExecutorWorker *worker, int index) {
+    ExecutorResults *results = executor->results;
+    if (run_job(executor, worker, index)) return;
+
+    results->succeeded[index] = 0;
+    if (results->outcomes) {
+        int *outcomes = results->outcomes + (size_t)index * (size_t)results->shots;
+        for (int shot = 0; shot < results->shots; shot++) outcomes[shot] = -1;
+    }
+}
+
+static void worker_loop(Executor *executor, int w) {
+    ExecutorWorker *worker = &executor->workers[w];
+    QuantumRandom *previous = quantum_random_thread_stream();
+    quantum_random_set_thread_stream(&worker->random);
+
+    for (;;) {
+        int position = deque_take(&executor->deques[w]);
+        if (position < 0) {
+            if (!deque_steal(executor, w)) break;
+            continue;
+        }
+        finish_job(executor, worker, executor->order[position]);
+    }
+    quantum_random_set_thread_stream(previous);
+}
+
+// =============================================================================
+// BATCH EXECUTION
+// =============================================================================
+
+static ExecutorResults* create_results(const QuantumCircuit *const *circuits, int num_circuits,
+                                       const ExecutorOptions *options) {
+    ExecutorResults *results = calloc(1, sizeof(ExecutorResults));
+    if (!results) return NULL;
+    results->num_circuits = num_circuits;
+    results->shots = options->shots;
+    results->succeeded = malloc((size_t)num_circuits * sizeof(int));
+    if (!results->succeeded) goto fail;
+    for (int i = 0; i < num_circuits; i++) results->succeeded[i] = 1;
+
+    if (options->shots > 0) {
+        results->outcomes = malloc((size_t)num_circuits * (size_t)options->shots * sizeof(int));
+        if (!results->outcomes) goto fail;
+    }
+    if (options->keep_states) {
+        results->state_offsets = malloc(((size_t)num_circuits + 1) * sizeof(size_t));
+        if (!results->state_offsets) goto fail;
+        size_t total = 0;
+        for (int i = 0; i < num_circuits; i++) {
+            results->state_offsets[i] = total;
+            if (circuit_is_valid(circuits[i])) total += (size_t)1 << circuits[i]->num_qubits;
+        }
+        results->state_offsets[num_circuits] = total;
+        results->amplitudes = calloc(total > 0 ? total : 1, sizeof(Complex));
+        if (!results->amplitudes) goto fail;
+    }
+    return results;
+
+fail:
+    fprintf(stderr, "Error: Failed to allocate batch results\n");
+    quantum_executor_results_destroy(results);
+    return NULL;
+}
+
+ExecutorResults* quantum_executor_run(const QuantumCircuit *const *circuits, int num_circuits,
+                                      const ExecutorOptions *options) {
+    ExecutorOptions settings = {0, 0, 0, 0, 0};
+    if (options) settings = *options;
+    if (!circuits || num_circuits < 1 || settings.shots < 0) {
+        fprintf(stderr, "Error: Invalid circuit batch\n");
+        return NULL;
+    }
+    if (settings.large_qubits <= 0) settings.large_qubits = EXECUTOR_DEFAULT_LARGE_QUBITS;
+    if (settings.num_workers <= 0) {
+#ifdef _OPENMP
+        settings.num_workers = omp_get_max_threads();
+#else
+        settings.num_workers = 1;
+#endif
+    }
+
+    for (int i = 0; i < num_circuits; i++) {
+        if (!circuit_is_valid(circuits[i])) {
+            fprintf(stderr, "Error: Circuit %d of the batch must have 1 to %d qubits\n", i, MAX_QUBITS);
+        }
+    }
+
+    ExecutorResults *results = create_results(circuits, num_circuits, &settings);
+    ExecutorJob *jobs = malloc((size_t)num_circuits * sizeof(ExecutorJob));
+    int *order = malloc((size_t)num_circuits * sizeof(int));
+    WorkDeque *deques = calloc((size_t)settings.num_workers, sizeof(WorkDeque));
+    ExecutorWorker *workers = calloc((size_t)settings.num_workers, sizeof(ExecutorWorker));
+    if (!results || !jobs || !order || !deques || !workers) {
+        fprintf(stderr, "Error: Failed to allocate the batch scheduler\n");
+        quantum_executor_results_destroy(results);
+        free(jobs);
+        free(order);
+        free(deques);
+        free(workers);
+        return NULL;
+    }
+
+    for (int i = 0; i < num_circuits; i++) {
+        const QuantumCircuit *circuit = circuits[i];
+        jobs[i].index = i;
+        jobs[i].cost = circuit_is_valid(circuit)
+                       ? (double)((size_t)1 << circuit->num_qubits) * (circuit->num_gates + 1) : 0.0;
+    }
+    qsort(jobs, (size_t)num_circuits, sizeof(ExecutorJob), compare_cost);
+
+    Executor executor = {circuits, &settings, results, order, deques, workers, settings.num_workers};
+
+    /* Large circuits run alone, each parallelised across the gate loops */
+    int num_large = 0;
+    while (num_large < num_circuits && circuit_is_valid(circuits[jobs[num_large].index]) &&
+           circuits[jobs[num_large].index]->num_qubits >= settings.large_qubits) {
+        num_large++;
+    }
+    QuantumRandom *previous = quantum_random_thread_stream();
+    quantum_random_set_thread_stream(&workers[0].random);
+    for (int k = 0; k < num_large; k++) {
+        finish_job(&executor, &workers[0], jobs[k].index);
+    }
+    quantum_random_set_thread_stream(previous);
+
+    /* Deal the rest round robin, so every deque holds a share of each size */
+    int num_small = num_circuits - num_large;
+    int position = 0;
+    for (int w = 0; w < settings.num_workers; w++) {
+        pthread_mutex_init(&deques[w].lock, NULL);
+        deques[w].begin = position;
+        for (int k = w; k < num_small; k += settings.num_workers) {
+            order[position++] = jobs[num_large + k].index;
+        }
+        deques[w].end = position;
+    }
+
+    /* Gate loops inside a worker are nested regions, which run on the worker's own thread */
+    #pragma omp parallel num_threads(settings.num_workers) if (num_small > 1)
+    {
+        int w = 0;
+#ifdef _OPENMP
+        w = omp_get_thread_num();
+#endif
+        worker_loop(&executor, w);
+    }
+
+    for (int w = 0; w < settings.num_workers; w++) {
+        pthread_mutex_destroy(&deques[w].lock);
+        for (int n = 0; n <= MAX_QUBITS; n++) quantum_state_destroy(workers[w].states[n]);
+        free(workers[w].cumulative);
+    }
+    for (int i = 0; i < num_circuits; i++) {
+        results->num_failed += !results->succeeded[i];
+    }
+
+    free(jobs);
+    free(order);
+    free(deques);
+    free(workers);
+    return results;
+}
+
+void quantum_executor_results_destroy(ExecutorResults *results) {
+    if (!results) return;
+    free(results->outcomes);
+    free(results->state_offsets);
+    free(results->amplitudes);
+    free(results->succeeded);
+    free(results);
+}
@@ -1,6 +1,17 @@
 #include "quantum_gates.h"
+#include "complex_kernels.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/* Define M_PI if not available */
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 int validate_single_qubit_gate(const QuantumState *state, int qubit) {
     if (!state) {
@@ -26,212 +37,626 @@ int validate_two_qubit_gate(const QuantumState *state, int qubit1, int qubit2) {
     return 1;
 }
 
-void gate_pauli_x(QuantumState *state, int qubit) {
-    if (!validate_single_qubit_gate(state, qubit)) return;
+int validate_oracle(int num_qubits, const QuantumOracle *oracle) {
+    if (!oracle || !oracle->function) {
+        fprintf(stderr, "Error: Null oracle function\n");
+        return 0;
+    }
+    if (oracle->input_width < 1 || oracle->output_width < 1 ||
+        oracle->input_qubit < 0 || oracle->input_qubit + oracle->input_width > num_qubits ||
+        oracle->output_qubit < 0 || oracle->output_qubit + oracle->output_width > num_qubits) {
+        fprintf(stderr, "Error: Oracle registers out of range [0, %d)\n", num_qubits);
+        return 0;
+    }
+    if (oracle->input_qubit < oracle->output_qubit + oracle->output_width &&
+        oracle->output_qubit < oracle->input_qubit + oracle->input_width) {
+        fprintf(stderr, "Error: Oracle input and output registers overlap\n");
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Product-form states (see quantum_state.h) apply single-qubit gates to the
+ * qubit's 2-vector. Controlled gates stay factored while the control is a
+ * basis state, or the target of a CNOT is an X eigenstate; anything else
+ * materialises the dense amplitudes first.
+ */
+#define PRODUCT_BASIS_TOLERANCE 1e-24  /* Squared magnitude treated as zero */
+
+static int apply_to_factor(QuantumState *state, int qubit, Complex m00, Complex m01, Complex m10, Complex m11) {
+    if (state->form != QUANTUM_FORM_PRODUCT) return 0;
+    
+    Complex *factor = state->factors + 2 * qubit;
+    Complex a0 = factor[0], a1 = factor[1];
+    factor[0] = complex_kernel_add(complex_kernel_multiply(m00, a0), complex_kernel_multiply(m01, a1));
+    factor[1] = complex_kernel_add(complex_kernel_multiply(m10, a0), complex_kernel_multiply(m11, a1));
+    return 1;
+}
+
+/* Returns 0 for |0⟩, 1 for |1⟩ (up to phase), -1 for a superposition */
+static int factor_basis(const QuantumState *state, int qubit) {
+    if (complex_kernel_magnitude_squared(state->factors[2 * qubit + 1]) < PRODUCT_BASIS_TOLERANCE) return 0;
+    if (complex_kernel_magnitude_squared(state->factors[2 * qubit]) < PRODUCT_BASIS_TOLERANCE) return 1;
+    return -1;
+}
+
+/* Controlled gate applying diag(1, phase) to the target when the control is 1;
+ * symmetric in its qubits, so either one being a basis state keeps it factored */
+static int apply_controlled_phase_to_factors(QuantumState *state, int qubit1, int qubit2, Complex phase) {
+    if (state->form != QUANTUM_FORM_PRODUCT) return 0;
+    
+    Complex one = complex_create(1.0, 0.0), zero = complex_create(0.0, 0.0);
+    int basis1 = factor_basis(state, qubit1), basis2 = factor_basis(state, qubit2);
     
-    int qubit_mask = 1 << qubit;
+    if (basis1 == 0 || basis2 == 0) return 1;
+    if (basis1 == 1) return apply_to_factor(state, qubit2, one, zero, zero, phase);
+    if (basis2 == 1) return apply_to_factor(state, qubit1, one, zero, zero, phase);
+    
+    quantum_state_materialise(state);
+    return 0;
+}
+
+static int apply_cnot_to_factors(QuantumState *state, int control, int target) {
+    if (state->form != QUANTUM_FORM_PRODUCT) return 0;
+    
+    Complex one = complex_create(1.0, 0.0), zero = complex_create(0.0, 0.0);
+    int basis = factor_basis(state, control);
+    if (basis == 0) return 1;
+    if (basis == 1) return apply_to_factor(state, target, zero, one, one, zero);
+    
+    /* X eigenstates: |+⟩ is unchanged, |−⟩ kicks a Z back onto the control */
+    Complex t0 = state->factors[2 * target], t1 = state->factors[2 * target + 1];
+    if (complex_kernel_magnitude_squared(complex_kernel_subtract(t0, t1)) < PRODUCT_BASIS_TOLERANCE) return 1;
+    if (complex_kernel_magnitude_squared(complex_kernel_add(t0, t1)) < PRODUCT_BASIS_TOLERANCE) {
+        return apply_to_factor(state, control, one, zero, zero, complex_create(-1.0, 0.0));
+    }
+    
+    quantum_state_materialise(state);
+    return 0;
+}
+
+/*
+ * The kernels below loop over amplitude pairs (or quads for two-qubit gates)
+ * by inserting zero bits into a dense counter, so each iteration does useful
+ * work. Large states use a static schedule: thread t always processes the
+ * same index range, which is the range it first touched in quantum_state_create.
+ */
+static inline int insert_zero_bit(int index, int qubit) {
+    int low = index & ((1 << qubit) - 1);
+    return ((index >> qubit) << (qubit + 1)) | low;
+}
+
+/* Base index of the quad with both qubits 0 */
+static inline int insert_zero_bits(int index, int qubit1, int qubit2) {
+    int low = qubit1 < qubit2 ? qubit1 : qubit2;
+    int high = qubit1 < qubit2 ? qubit2 : qubit1;
+    return insert_zero_bit(insert_zero_bit(index, low), high);
+}
+
+/*
+ * Consecutive counters map to contiguous base indices up to the lowest gate
+ * qubit, or to every other index when that qubit is 0. The counter range is
+ * therefore cut into runs, and each run is a single call into the inline
+ * kernels of complex_kernels.h with a constant stride of 1 or 2.
+ */
+#define GATE_RUN_CHUNK 4096  /* Pairs or quads per parallel work item */
+
+typedef enum {
+    RUN_SWAP,         /* a ↔ b */
+    RUN_SCALE,        /* a *= m[0] */
+    RUN_SCALE_REAL,   /* a *= m[0].real */
+    RUN_DIAGONAL,     /* a *= m[0], b *= m[3] */
+    RUN_MATRIX,       /* (a, b) ← m (a, b) */
+    RUN_REAL_MATRIX   /* As RUN_MATRIX with the real parts of m */
+} RunKernel;
+
+typedef struct {
+    RunKernel kernel;
+    int offset_a;  /* Offsets of the operands from the run's base index */
+    int offset_b;
+    Complex m[4];
+} RunOp;
+
+static inline void apply_run(Complex *base, size_t count, size_t stride, const RunOp *op) {
+    Complex *a = base + op->offset_a;
+    Complex *b = base + op->offset_b;
+    const Complex *m = op->m;
+    
+    switch (op->kernel) {
+        case RUN_SWAP:
+            complex_kernel_swap(a, b, count, stride);
+            break;
+        case RUN_SCALE:
+            complex_kernel_scale(a, count, stride, m[0]);
+            break;
+        case RUN_SCALE_REAL:
+            complex_kernel_scale_real(a, count, stride, m[0].real);
+            break;
+        case RUN_DIAGONAL:
+            complex_kernel_scale(a, count, stride, m[0]);
+            complex_kernel_scale(b, count, stride, m[3]);
+            break;
+        case RUN_MATRIX:
+            complex_kernel_apply_2x2(a, b, count, stride, m[0], m[1], m[2], m[3]);
+            break;
+        case RUN_REAL_MATRIX:
+            complex_kernel_apply_real_2x2(a, b, count, stride, m[0].real, m[1].real, m[2].real, m[3].real);
+            break;
+    }
+}
+
+/* Applies op to every pair of qubit1 (qubit2 < 0) or every quad of qubit1 and qubit2 */
+static void apply_runs(QuantumState *state, int qubit1, int qubit2, const RunOp *op) {
+    int low = (qubit2 < 0 || qubit1 < qubit2) ? qubit1 : qubit2;
+    int high = qubit2 < 0 ? -1 : (qubit1 < qubit2 ? qubit2 : qubit1);
+    int num_groups = state->num_states >> (qubit2 < 0 ? 1 : 2);
+    int run_length = low > 0 ? 1 << low : (high > 0 ? 1 << (high - 1) : num_groups);
+    int num_chunks = (num_groups + GATE_RUN_CHUNK - 1) / GATE_RUN_CHUNK;
     
-    /* Iterate through all basis states and swap amplitudes */
-    for (int i = 0; i < state->num_states; i++) {
-        if (!(i & qubit_mask)) {  /* Only process states where this qubit is 0 */
-            int flipped_state = i | qubit_mask;  /* Flip this qubit to 1 */
+    #pragma omp parallel for schedule(static) if (num_groups >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        int t = chunk * GATE_RUN_CHUNK;
+        int end = t + GATE_RUN_CHUNK < num_groups ? t + GATE_RUN_CHUNK : num_groups;
+        
+        while (t < end) {
+            int count = run_length - (t & (run_length - 1));
+            if (count > end - t) count = end - t;
             
-            /* Swap amplitudes */
-            Complex temp = state->amplitudes[i];
-            state->amplitudes[i] = state->amplitudes[flipped_state];
-            state->amplitudes[flipped_state] = temp;
+            int base = qubit2 < 0 ? insert_zero_bit(t, qubit1) : insert_zero_bits(t, qubit1, qubit2);
+            if (low > 0) {
+                apply_run(state->amplitudes + base, (size_t)count, 1, op);
+            } else {
+                apply_run(state->amplitudes + base, (size_t)count, 2, op);
+            }
+            t += count;
         }
     }
 }
 
-void gate_pauli_y(QuantumState *state, int qubit) {
+static void apply_single_qubit_run(QuantumState *state, int qubit, RunKernel kernel,
+                                   Complex m00, Complex m01, Complex m10, Complex m11) {
+    RunOp op = {kernel, 0, 1 << qubit, {m00, m01, m10, m11}};
+    apply_runs(state, qubit, -1, &op);
+}
+
+void gate_pauli_x(QuantumState *state, int qubit) {
     if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex zero = complex_create(0.0, 0.0), one = complex_create(1.0, 0.0);
+    if (apply_to_factor(state, qubit, zero, one, one, zero)) return;
     
-    int qubit_mask = 1 << qubit;
+    /* Swap the amplitudes of each pair differing in this qubit */
+    apply_single_qubit_run(state, qubit, RUN_SWAP, one, zero, zero, one);
+}
+
+void gate_pauli_y(QuantumState *state, int qubit) {
+    if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex zero = complex_create(0.0, 0.0);
     Complex i_unit = complex_create(0.0, 1.0);
     Complex neg_i_unit = complex_create(0.0, -1.0);
+    if (apply_to_factor(state, qubit, zero, neg_i_unit, i_unit, zero)) return;
     
-    for (int i = 0; i < state->num_states; i++) {
-        if (!(i & qubit_mask)) {  /* Only process states where this qubit is 0 */
-            int flipped_state = i | qubit_mask;  /* Flip this qubit to 1 */
-            
-            Complex temp0 = state->amplitudes[i];
-            Complex temp1 = state->amplitudes[flipped_state];
-            
-            state->amplitudes[i] = complex_multiply(neg_i_unit, temp1);
-            state->amplitudes[flipped_state] = complex_multiply(i_unit, temp0);
-        }
-    }
+    apply_single_qubit_run(state, qubit, RUN_MATRIX, zero, neg_i_unit, i_unit, zero);
 }
 
 void gate_pauli_z(QuantumState *state, int qubit) {
     if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex zero = complex_create(0.0, 0.0), one = complex_create(1.0, 0.0);
+    Complex minus_one = complex_create(-1.0, 0.0);
+    if (apply_to_factor(state, qubit, one, zero, zero, minus_one)) return;
     
-    int qubit_mask = 1 << qubit;
-    
-    for (int i = 0; i < state->num_states; i++) {
-        if (i & qubit_mask) {
-            state->amplitudes[i].real = -state->amplitudes[i].real;
-            state->amplitudes[i].imag = -state->amplitudes[i].imag;
-        }
-    }
+    /* Only the |1⟩ member of each pair changes */
+    RunOp op = {RUN_SCALE_REAL, 1 << qubit, 1 << qubit, {minus_one, zero, zero, zero}};
+    apply_runs(state, qubit, -1, &op);
 }
 
 void gate_hadamard(QuantumState *state, int qubit) {
     if (!validate_single_qubit_gate(state, qubit)) return;
-    
-    int qubit_mask = 1 << qubit;
     double factor = 1.0 / sqrt(2.0);
+    Complex plus = complex_create(factor, 0.0), minus = complex_create(-factor, 0.0);
+    if (apply_to_factor(state, qubit, plus, plus, plus, minus)) return;
     
-    for (int i = 0; i < state->num_states; i++) {
-        if (!(i & qubit_mask)) {  /* Only process states where this qubit is 0 */
-            int flipped_state = i | qubit_mask;  /* Corresponding state with qubit = 1 */
-            
-            Complex amp0 = state->amplitudes[i];
-            Complex amp1 = state->amplitudes[flipped_state];
-            
-            state->amplitudes[i] = complex_create(
-                factor * (amp0.real + amp1.real),
-                factor * (amp0.imag + amp1.imag)
-            );
-            state->amplitudes[flipped_state] = complex_create(
-                factor * (amp0.real - amp1.real),
-                factor * (amp0.imag - amp1.imag)
-            );
-        }
-    }
+    apply_single_qubit_run(state, qubit, RUN_REAL_MATRIX, plus, plus, plus, minus);
 }
 
 void gate_phase(QuantumState *state, int qubit, double phase) {
     if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex zero = complex_create(0.0, 0.0), one = complex_create(1.0, 0.0);
+    Complex phase_factor = complex_kernel_from_polar(1.0, phase);
+    if (apply_to_factor(state, qubit, one, zero, zero, phase_factor)) return;
     
-    int qubit_mask = 1 << qubit;
-    Complex phase_factor = complex_from_polar(1.0, phase);
-    
-    for (int i = 0; i < state->num_states; i++) {
-        if (i & qubit_mask) {
-            state->amplitudes[i] = complex_multiply(state->amplitudes[i], phase_factor);
-        }
-    }
+    RunOp op = {RUN_SCALE, 1 << qubit, 1 << qubit, {phase_factor, zero, zero, zero}};
+    apply_runs(state, qubit, -1, &op);
 }
 
 void gate_rotation_x(QuantumState *state, int qubit, double angle) {
     if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex cos_half = complex_create(cos(angle / 2.0), 0.0);
+    Complex neg_i_sin = complex_create(0.0, -sin(angle / 2.0));
+    if (apply_to_factor(state, qubit, cos_half, neg_i_sin, neg_i_sin, cos_half)) return;
     
-    int qubit_mask = 1 << qubit;
+    apply_single_qubit_run(state, qubit, RUN_MATRIX, cos_half, neg_i_sin, neg_i_sin, cos_half);
+}
+
+void gate_rotation_y(QuantumState *state, int qubit, double angle) {
+    if (!validate_single_qubit_gate(state, qubit)) return;
     double cos_half = cos(angle / 2.0);
     double sin_half = sin(angle / 2.0);
-    Complex neg_i_sin = complex_create(0.0, -sin_half);
+    Complex c = complex_create(cos_half, 0.0);
+    Complex s = complex_create(sin_half, 0.0), neg_s = complex_create(-sin_half, 0.0);
+    if (apply_to_factor(state, qubit, c, neg_s, s, c)) return;
     
-    for (int i = 0; i < state->num_states; i++) {
-        if (!(i & qubit_mask)) {  /* Only process states where this qubit is 0 */
-            int flipped_state = i | qubit_mask;
-            
-            Complex amp0 = state->amplitudes[i];
-            Complex amp1 = state->amplitudes[flipped_state];
-            
-            state->amplitudes[i] = complex_add(
-                complex_create(cos_half * amp0.real, cos_half * amp0.imag),
-                complex_multiply(neg_i_sin, amp1)
-            );
-            state->amplitudes[flipped_state] = complex_add(
-                complex_multiply(neg_i_sin, amp0),
-                complex_create(cos_half * amp1.real, cos_half * amp1.imag)
-            );
-        }
-    }
+    apply_single_qubit_run(state, qubit, RUN_REAL_MATRIX, c, neg_s, s, c);
 }
 
-void gate_rotation_y(QuantumState *state, int qubit, double angle) {
+void gate_rotation_z(QuantumState *state, int qubit, double angle) {
     if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex zero = complex_create(0.0, 0.0);
+    Complex phase_0 = complex_kernel_from_polar(1.0, -angle / 2.0);
+    Complex phase_1 = complex_kernel_from_polar(1.0, angle / 2.0);
+    if (apply_to_factor(state, qubit, phase_0, zero, zero, phase_1)) return;
     
-    int qubit_mask = 1 << qubit;
-    double cos_half = cos(angle / 2.0);
-    double sin_half = sin(angle / 2.0);
+    apply_single_qubit_run(state, qubit, RUN_DIAGONAL, phase_0, zero, zero, phase_1);
+}
+
+void gate_unitary(QuantumState *state, int qubit, const Complex matrix[4]) {
+    if (!validate_single_qubit_gate(state, qubit)) return;
+    Complex m00 = matrix[0], m01 = matrix[1], m10 = matrix[2], m11 = matrix[3];
+    if (apply_to_factor(state, qubit, m00, m01, m10, m11)) return;
     
-    for (int i = 0; i < state->num_states; i++) {
-        if (!(i & qubit_mask)) {  /* Only process states where this qubit is 0 */
-            int flipped_state = i | qubit_mask;
-            
-            Complex amp0 = state->amplitudes[i];
-            Complex amp1 = state->amplitudes[flipped_state];
-            
-            state->amplitudes[i] = complex_create(
-                cos_half * amp0.real - sin_half * amp1.real,
-                cos_half * amp0.imag - sin_half * amp1.imag
-            );
-            state->amplitudes[flipped_state] = complex_create(
-                sin_half * amp0.real + cos_half * amp1.real,
-                sin_half * amp0.imag + cos_half * amp1.imag
-            );
+    apply_single_qubit_run(state, qubit, RUN_MATRIX, m00, m01, m10, m11);
+}
+
+void gate_cnot(QuantumState *state, int control, int target) {
+    if (!validate_two_qubit_gate(state, control, target)) return;
+    if (apply_cnot_to_factors(state, control, target)) return;
+    
+    /* Swap the target pair within each quad whose control qubit is 1 */
+    int control_mask = 1 << control;
+    RunOp op = {RUN_SWAP, control_mask, control_mask | (1 << target), {{0.0, 0.0}}};
+    apply_runs(state, control, target, &op);
+}
+
+void gate_cz(QuantumState *state, int control, int target) {
+    if (!validate_two_qubit_gate(state, control, target)) return;
+    if (apply_controlled_phase_to_factors(state, control, target, complex_create(-1.0, 0.0))) return;
+    
+    /* Only the member with both qubits 1 changes */
+    int both = (1 << control) | (1 << target);
+    RunOp op = {RUN_SCALE_REAL, both, both, {{-1.0, 0.0}}};
+    apply_runs(state, control, target, &op);
+}
+
+void gate_controlled_phase(QuantumState *state, int control, int target, double phase) {
+    if (!validate_two_qubit_gate(state, control, target)) return;
+    Complex phase_factor = complex_kernel_from_polar(1.0, phase);
+    if (apply_controlled_phase_to_factors(state, control, target, phase_factor)) return;
+    
+    int both = (1 << control) | (1 << target);
+    RunOp op = {RUN_SCALE, both, both, {phase_factor}};
+    apply_runs(state, control, target, &op);
+}
+
+void gate_swap(QuantumState *state, int qubit1, int qubit2) {
+    if (!validate_two_qubit_gate(state, qubit1, qubit2)) return;
+    
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        for (int bit = 0; bit < 2; bit++) {
+            Complex temp = state->factors[2 * qubit1 + bit];
+            state->factors[2 * qubit1 + bit] = state->factors[2 * qubit2 + bit];
+            state->factors[2 * qubit2 + bit] = temp;
         }
+        return;
     }
+    
+    /* Only the |01⟩ and |10⟩ members of each quad move */
+    RunOp op = {RUN_SWAP, 1 << qubit1, 1 << qubit2, {{0.0, 0.0}}};
+    apply_runs(state, qubit1, qubit2, &op);
 }
 
-void gate_rotation_z(QuantumState *state, int qubit, double angle) {
-    if (!validate_single_qubit_gate(state, qubit)) return;
+/*
+ * Quantum Fourier Transform on the contiguous qubit range [first, last].
+ *
+ * The QFT over m qubits is a normalised length-2^m DFT of the amplitudes
+ * indexed by those qubits, so it is computed as an in-place iterative FFT
+ * rather than as O(m^2) controlled-phase passes.  The qubits below `first`
+ * index a contiguous run of amplitudes ("row"), so every butterfly operates
+ * on two whole rows; the qubits above `last` select independent batches.
+ * Stages are fused in pairs (radix-4) to halve the number of sweeps.
+ *
+ * Many batches are spread over threads whole. A single large batch is shared
+ * instead: the early stages only combine rows within one FFT_CACHE_BLOCK, so
+ * each block runs all of them while it is in cache, and only the later
+ * stages sweep the batch, one shared pass each.
+ */
+#define FFT_CACHE_BLOCK 4096  /* Amplitudes taken through the early stages together */
+#define FFT_WORK_ITEM 1024    /* Amplitudes per row segment handed to a thread */
+
+static int reverse_bits(int value, int m) {
+    int reversed = 0;
+    for (int bit = m >> 1; bit > 0; bit >>= 1, value >>= 1) {
+        reversed |= (value & 1) * bit;
+    }
+    return reversed;
+}
+
+/* Swaps rows [begin, end) with their bit-reversed partners, columns [k_begin, k_end) */
+static void bit_reverse_rows(Complex *rows, size_t inner, int m, int begin, int end,
+                             size_t k_begin, size_t k_end) {
+    for (int r = begin, rev = reverse_bits(begin, m); r < end; r++) {
+        if (rev > r) {
+            complex_kernel_swap(rows + (size_t)r * inner + k_begin, rows + (size_t)rev * inner + k_begin,
+                                k_end - k_begin, 1);
+        }
+        /* Increment rev in reversed bit order */
+        int bit = m >> 1;
+        while (rev & bit) {
+            rev ^= bit;
+            bit >>= 1;
+        }
+        rev |= bit;
+    }
+}
+
+/* Stages of length 2*half (radix 2) or 2*half and 4*half fused (radix 4) */
+static int stage_radix(int half, int m) {
+    return half * 4 <= m ? 4 : 2;
+}
+
+/* Radix-4 butterfly on one element of each of four rows; w1 carries the input scale */
+static inline void butterfly4(Complex *r0, Complex *r1, Complex *r2, Complex *r3,
+                              Complex w1_scaled, Complex w2, Complex w3, double s) {
+    Complex a0 = {s * r0->real, s * r0->imag};
+    Complex a1 = complex_kernel_multiply(w1_scaled, *r1);
+    Complex a2 = {s * r2->real, s * r2->imag};
+    Complex a3 = complex_kernel_multiply(w1_scaled, *r3);
+    
+    Complex b0 = complex_kernel_add(a0, a1);
+    Complex b1 = complex_kernel_subtract(a0, a1);
+    Complex b2 = complex_kernel_multiply(w2, complex_kernel_add(a2, a3));
+    Complex b3 = complex_kernel_multiply(w3, complex_kernel_subtract(a2, a3));
     
-    Complex phase_0 = complex_from_polar(1.0, -angle / 2.0);
-    Complex phase_1 = complex_from_polar(1.0, angle / 2.0);
-    int qubit_mask = 1 << qubit;
+    *r0 = complex_kernel_add(b0, b2);
+    *r2 = complex_kernel_subtract(b0, b2);
+    *r1 = complex_kernel_add(b1, b3);
+    *r3 = complex_kernel_subtract(b1, b3);
+}
+
+static inline void butterfly2(Complex *r0, Complex *r1, Complex w_scaled, double s) {
+    Complex a0 = {s * r0->real, s * r0->imag};
+    Complex a1 = complex_kernel_multiply(w_scaled, *r1);
+    *r0 = complex_kernel_add(a0, a1);
+    *r1 = complex_kernel_subtract(a0, a1);
+}
+
+/*
+ * Butterflies [begin, end) of one decimation-in-time stage, columns
+ * [k_begin, k_end). The rows may be a sub-block of a length-size transform;
+ * its twiddles are the size-point ones at a stride. s scales the input.
+ * Butterfly t is j = t mod half of the group starting at row (t - j) * radix.
+ * Rows of one amplitude are vectorised across j instead of k.
+ */
+static void fft_butterflies(Complex *rows, size_t inner, int half, int radix, int size, const Complex *twiddles,
+                            double s, int sign, int begin, int end, size_t k_begin, size_t k_end) {
+    int step = size / (radix * half);  /* Twiddle stride of the longest stage */
     
-    for (int i = 0; i < state->num_states; i++) {
-        if (i & qubit_mask) {
-            state->amplitudes[i] = complex_multiply(state->amplitudes[i], phase_1);
+    for (int t = begin; t < end; ) {
+        int j0 = t & (half - 1);
+        int count = half - j0 < end - t ? half - j0 : end - t;
+        Complex *group = rows + (size_t)(t - j0) * radix * inner;
+        size_t span = (size_t)half * inner;
+        
+        if (inner == 1) {
+            if (radix == 4) {
+                #pragma omp simd
+                for (int j = j0; j < j0 + count; j++) {
+                    Complex w1 = twiddles[2 * j * step], w2 = twiddles[j * step];
+                    Complex w3 = {-sign * w2.imag, sign * w2.real};  /* w2 * (sign * i) */
+                    Complex w1_scaled = {s * w1.real, s * w1.imag};
+                    butterfly4(group + j, group + j + span, group + j + 2 * span, group + j + 3 * span,
+                               w1_scaled, w2, w3, s);
+                }
+            } else {
+                #pragma omp simd
+                for (int j = j0; j < j0 + count; j++) {
+                    Complex w = twiddles[j * step];
+                    Complex w_scaled = {s * w.real, s * w.imag};
+                    butterfly2(group + j, group + j + span, w_scaled, s);
+                }
+            }
         } else {
-            state->amplitudes[i] = complex_multiply(state->amplitudes[i], phase_0);
+            for (int j = j0; j < j0 + count; j++) {
+                Complex *r0 = group + (size_t)j * inner;
+                if (radix == 4) {
+                    Complex w1 = twiddles[2 * j * step], w2 = twiddles[j * step];
+                    Complex w3 = {-sign * w2.imag, sign * w2.real};
+                    Complex w1_scaled = {s * w1.real, s * w1.imag};
+                    
+                    /* The rows are distinct, so every k is independent */
+                    #pragma omp simd
+                    for (size_t k = k_begin; k < k_end; k++) {
+                        butterfly4(r0 + k, r0 + span + k, r0 + 2 * span + k, r0 + 3 * span + k, w1_scaled, w2, w3, s);
+                    }
+                } else {
+                    Complex w = twiddles[j * step];
+                    Complex w_scaled = {s * w.real, s * w.imag};
+                    
+                    #pragma omp simd
+                    for (size_t k = k_begin; k < k_end; k++) {
+                        butterfly2(r0 + k, r0 + span + k, w_scaled, s);
+                    }
+                }
+            }
         }
+        t += count;
     }
 }
 
-void gate_cnot(QuantumState *state, int control, int target) {
-    if (!validate_two_qubit_gate(state, control, target)) return;
+/* Every stage over m rows on one thread; expects bit-reversed input, gives natural order */
+static void fft_butterfly_rows(Complex *rows, size_t inner, int m, int size, const Complex *twiddles,
+                               double scale, int sign) {
+    double s = scale;  /* Normalisation is folded into the first stage */
+    for (int half = 1; half < m; ) {
+        int radix = stage_radix(half, m);
+        fft_butterflies(rows, inner, half, radix, size, twiddles, s, sign, 0, m / radix, 0, inner);
+        half *= radix;
+        s = 1.0;
+    }
+}
+
+/* One batch on the calling thread */
+static void fft_batch(Complex *rows, size_t inner, int m, const Complex *twiddles, double scale, int sign,
+                      int msb_first) {
+    /* Reversing the output instead of the input is the same DFT with
+     * both index registers read in reversed bit order */
+    if (!msb_first) bit_reverse_rows(rows, inner, m, 0, m, 0, inner);
+    fft_butterfly_rows(rows, inner, m, m, twiddles, scale, sign);
+    if (msb_first) bit_reverse_rows(rows, inner, m, 0, m, 0, inner);
+}
+
+/* One batch shared by all threads; work items are row segments of at most
+ * FFT_WORK_ITEM amplitudes, so even a few long rows are split */
+static void fft_batch_shared(Complex *rows, size_t inner, int m, const Complex *twiddles, double scale, int sign,
+                             int msb_first) {
+    size_t segment = inner < FFT_WORK_ITEM ? inner : FFT_WORK_ITEM;
+    int segments = (int)(inner / segment);
+    int rows_per_item = inner < FFT_WORK_ITEM ? (int)(FFT_WORK_ITEM / inner) : 1;
+    if (rows_per_item > m) rows_per_item = m;
+    int row_items = m / rows_per_item * segments;
     
-    int control_mask = 1 << control;
-    int target_mask = 1 << target;
+    /* Rows per cache block; below radix 4 there is nothing to fuse */
+    int local = inner < FFT_CACHE_BLOCK ? (int)(FFT_CACHE_BLOCK / inner) : 1;
+    if (local > m) local = m;
+    if (local < 4) local = 1;
     
-    /* Process each basis state */
-    for (int i = 0; i < state->num_states; i++) {
-        if (i & control_mask) {  /* Control qubit is 1 */
-            int partner_state = i ^ target_mask;  /* Flip target qubit */
+    #pragma omp parallel
+    {
+        if (!msb_first) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < row_items; i++) {
+                int r = i / segments * rows_per_item;
+                size_t k = (size_t)(i % segments) * segment;
+                bit_reverse_rows(rows, inner, m, r, r + rows_per_item, k, k + segment);
+            }
+        }
+        
+        if (local > 1) {
+            #pragma omp for schedule(static)
+            for (int b = 0; b < m / local; b++) {
+                fft_butterfly_rows(rows + (size_t)b * local * inner, inner, local, m, twiddles, scale, sign);
+            }
+        }
+        
+        double s = local > 1 ? 1.0 : scale;
+        for (int half = local; half < m; ) {
+            int radix = stage_radix(half, m);
+            int per_item = rows_per_item / radix > 0 ? rows_per_item / radix : 1;
+            int items = (m / radix) / per_item * segments;
             
-            /* Only swap if we haven't processed this pair yet */
-            if (partner_state > i) {
-                Complex temp = state->amplitudes[i];
-                state->amplitudes[i] = state->amplitudes[partner_state];
-                state->amplitudes[partner_state] = temp;
+            #pragma omp for schedule(static)
+            for (int i = 0; i < items; i++) {
+                int t = i / segments * per_item;
+                size_t k = (size_t)(i % segments) * segment;
+                fft_butterflies(rows, inner, half, radix, m, twiddles, s, sign, t, t + per_item, k, k + segment);
+            }
+            half *= radix;
+            s = 1.0;
+        }
+        
+        if (msb_first) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < row_items; i++) {
+                int r = i / segments * rows_per_item;
+                size_t k = (size_t)(i % segments) * segment;
+                bit_reverse_rows(rows, inner, m, r, r + rows_per_item, k, k + segment);
             }
         }
     }
 }
 
-void gate_cz(QuantumState *state, int control, int target) {
-    if (!validate_two_qubit_gate(state, control, target)) return;
+static void apply_fourier_transform(QuantumState *state, int first, int last, int sign, int msb_first) {
+    if (!validate_single_qubit_gate(state, first) || !validate_single_qubit_gate(state, last)) return;
+    if (first > last) {
+        fprintf(stderr, "Error: Invalid QFT qubit range [%d, %d]\n", first, last);
+        return;
+    }
+    quantum_state_materialise(state);
     
-    int control_mask = 1 << control;
-    int target_mask = 1 << target;
+    int m = 1 << (last - first + 1);
+    size_t inner = (size_t)1 << first;
+    size_t block = inner * m;
+    int num_batches = (int)((size_t)state->num_states / block);
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    
+    /* Twiddle table: W^k = exp(sign * 2*pi*i * k / m) for k < m/2 */
+    Complex *twiddles = malloc((m / 2) * sizeof(Complex));
+    if (!twiddles) {
+        fprintf(stderr, "Error: Failed to allocate memory for QFT twiddles\n");
+        return;
+    }
+    for (int k = 0; k < m / 2; k++) {
+        twiddles[k] = complex_kernel_from_polar(1.0, sign * 2.0 * M_PI * k / m);
+    }
     
-    for (int i = 0; i < state->num_states; i++) {
-        if ((i & control_mask) && (i & target_mask)) {  /* Both qubits are 1 */
-            state->amplitudes[i].real = -state->amplitudes[i].real;
-            state->amplitudes[i].imag = -state->amplitudes[i].imag;
+    double scale = 1.0 / sqrt((double)m);
+    /* One thread also shares a large batch with itself, for the cache blocking */
+    if (block >= QUANTUM_PARALLEL_THRESHOLD && (num_batches < num_threads || num_threads == 1)) {
+        for (int b = 0; b < num_batches; b++) {
+            fft_batch_shared(state->amplitudes + (size_t)b * block, inner, m, twiddles, scale, sign, msb_first);
+        }
+    } else {
+        #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+        for (int b = 0; b < num_batches; b++) {
+            fft_batch(state->amplitudes + (size_t)b * block, inner, m, twiddles, scale, sign, msb_first);
         }
     }
+    
+    free(twiddles);
 }
 
-void gate_swap(QuantumState *state, int qubit1, int qubit2) {
-    if (!validate_two_qubit_gate(state, qubit1, qubit2)) return;
+void gate_qft(QuantumState *state, int first_qubit, int last_qubit) {
+    apply_fourier_transform(state, first_qubit, last_qubit, 1, 0);
+}
+
+void gate_inverse_qft(QuantumState *state, int first_qubit, int last_qubit) {
+    apply_fourier_transform(state, first_qubit, last_qubit, -1, 0);
+}
+
+void gate_qft_msb_first(QuantumState *state, int first_qubit, int last_qubit) {
+    apply_fourier_transform(state, first_qubit, last_qubit, 1, 1);
+}
+
+void gate_oracle(QuantumState *state, const QuantumOracle *oracle) {
+    if (!state) {
+        fprintf(stderr, "Error: Null quantum state\n");
+        return;
+    }
+    if (!validate_oracle(state->num_qubits, oracle)) return;
+    quantum_state_materialise(state);
     
-    int mask1 = 1 << qubit1;
-    int mask2 = 1 << qubit2;
+    int in_shift = oracle->input_qubit;
+    int out_shift = oracle->output_qubit;
+    int num_inputs = 1 << oracle->input_width;
+    unsigned int out_mask = (1u << oracle->output_width) - 1;
+    int below_mask = (1 << in_shift) - 1;
+    int num_rest = state->num_states >> oracle->input_width;
     
-    for (int i = 0; i < state->num_states; i++) {
-        int bit1 = (i & mask1) ? 1 : 0;
-        int bit2 = (i & mask2) ? 1 : 0;
+    /* f is evaluated once per input value; each x-slice is an independent
+     * involution (y ↔ y ⊕ f(x)), so slices run in parallel without conflicts */
+    #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int x = 0; x < num_inputs; x++) {
+        int flip = (int)(oracle->function((unsigned int)x, oracle->context) & out_mask) << out_shift;
+        if (flip == 0) continue;
         
-        if (bit1 != bit2) {  /* Only swap if bits are different */
-            int j = i ^ mask1 ^ mask2;  /* Swap the two bits */
-            if (j > i) {  /* Only swap once */
+        int x_bits = x << in_shift;
+        for (int r = 0; r < num_rest; r++) {
+            /* Deposit the remaining bits around the input register */
+            int i = (r & below_mask) | x_bits | ((r & ~below_mask) << oracle->input_width);
+            int j = i ^ flip;
+            if (j > i) {
                 Complex temp = state->amplitudes[i];
                 state->amplitudes[i] = state->amplitudes[j];
                 state->amplitudes[j] = temp;
@@ -0,0 +1,118 @@
+#include "quantum_gradient.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Applies U† for a gate of the program */
+static int apply_inverse_gate(const QuantumGate *gate, QuantumState *state) {
+    QuantumGate inverse = *gate;
+    
+    switch (gate->type) {
+        case GATE_PHASE:
+        case GATE_ROTATION_X:
+        case GATE_ROTATION_Y:
+        case GATE_ROTATION_Z:
+        case GATE_CONTROLLED_PHASE:
+            inverse.parameter = -gate->parameter;
+            break;
+        case GATE_QFT:
+            inverse.type = GATE_IQFT;
+            break;
+        case GATE_IQFT:
+            inverse.type = GATE_QFT;
+            break;
+        default:
+            /* X, Y, Z, H, CNOT, CZ, SWAP and XOR oracles are self-inverse */
+            break;
+    }
+    return quantum_circuit_apply_gate(&inverse, state, NULL);
+}
+
+/* 2 Re⟨λ|∂U ψ_before⟩ expressed through ψ_after = U ψ_before */
+static double gate_derivative(const QuantumGate *gate, const QuantumState *lambda, const QuantumState *psi) {
+    uint32_t mask = 1u << gate->qubit1;
+    PauliTerm generator = {0, 0, 1.0};
+    
+    switch (gate->type) {
+        case GATE_ROTATION_X: generator.x_mask = mask; break;
+        case GATE_ROTATION_Y: generator.x_mask = mask; generator.z_mask = mask; break;
+        case GATE_ROTATION_Z: generator.z_mask = mask; break;
+        case GATE_PHASE:
+            {
+                /* ∂P = i|1⟩⟨1|P with |1⟩⟨1| = (I - Z)/2 */
+                PauliTerm identity = {0, 0, 1.0};
+                PauliTerm z = {0, mask, 1.0};
+                Complex overlap = quantum_pauli_matrix_element(lambda, identity, psi);
+                Complex z_overlap = quantum_pauli_matrix_element(lambda, z, psi);
+                return -(overlap.imag - z_overlap.imag);
+            }
+        default:
+            return 0.0;
+    }
+    
+    /* R(θ) = exp(-iθG/2), so 2 Re⟨λ|(-i/2) G ψ⟩ = Im⟨λ|G|ψ⟩ */
+    return quantum_pauli_matrix_element(lambda, generator, psi).imag;
+}
+
+int quantum_gradient_adjoint(const QuantumProgram *program, const PauliObservable *observable,
+                             const QuantumState *initial_state, double *expectation, double *gradients) {
+    if (!program || !observable || !initial_state) {
+        fprintf(stderr, "Error: Null program, observable or state\n");
+        return 0;
+    }
+    if (program->num_qubits != initial_state->num_qubits || observable->num_qubits != initial_state->num_qubits) {
+        fprintf(stderr, "Error: Program, observable and state have different numbers of qubits\n");
+        return 0;
+    }
+    if (program->num_parameters > 0 && !gradients) {
+        fprintf(stderr, "Error: Null gradient output\n");
+        return 0;
+    }
+    for (int g = 0; g < program->num_gates; g++) {
+        GateType type = program->gates[g].type;
+        if (type == GATE_MEASURE || type == GATE_MEASURE_ALL) {
+            fprintf(stderr, "Error: Cannot differentiate through measurement (gate %d)\n", g);
+            return 0;
+        }
+    }
+    
+    QuantumState *psi = quantum_state_copy(initial_state);
+    QuantumState *lambda = quantum_state_create(initial_state->num_qubits);
+    if (!psi || !lambda) {
+        quantum_state_destroy(psi);
+        quantum_state_destroy(lambda);
+        return 0;
+    }
+    
+    int success = quantum_program_execute(program, psi) &&
+                  quantum_observable_apply(observable, psi, lambda);
+    
+    if (success) {
+        if (expectation) {
+            PauliTerm identity = {0, 0, 1.0};
+            *expectation = quantum_pauli_matrix_element(psi, identity, lambda).real;
+        }
+        
+        for (int p = 0; p < program->num_parameters; p++) {
+            gradients[p] = 0.0;
+        }
+        
+        /* Backward sweep: at gate g, psi = ψ_g and lambda = U_{>g}† H ψ */
+        for (int g = program->num_gates - 1; g >= 0 && success; g--) {
+            const QuantumGate *gate = &program->gates[g];
+            
+            if (gate->parameter_index >= 0) {
+                gradients[gate->parameter_index] += gate_derivative(gate, lambda, psi);
+            }
+            
+            success = apply_inverse_gate(gate, psi);
+            if (success && g > 0) {
+                success = apply_inverse_gate(gate, lambda);
+            }
+        }
+    }
+    
+    quantum_state_destroy(psi);
+    quantum_state_destroy(lambda);
+    return success;
+}
@@ -0,0 +1,235 @@
+#include "quantum_grover.h"
+#include "quantum_utils.h"
+#include "complex_kernels.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+/* Define M_PI if not available */
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define GROVER_PREDICATE_BLOCK 4096
+
+static inline int is_marked(const uint64_t *bits, int index) {
+    return (int)((bits[index >> 6] >> (index & 63)) & 1);
+}
+
+// =============================================================================
+// MARK SETS
+// =============================================================================
+
+GroverMarkSet* quantum_grover_marks_create(int num_qubits) {
+    if (num_qubits < 1 || num_qubits > MAX_QUBITS) {
+        fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_QUBITS);
+        return NULL;
+    }
+    
+    GroverMarkSet *marks = malloc(sizeof(GroverMarkSet));
+    if (!marks) {
+        fprintf(stderr, "Error: Failed to allocate memory for Grover mark set\n");
+        return NULL;
+    }
+    
+    marks->num_qubits = num_qubits;
+    marks->num_states = 1 << num_qubits;
+    marks->num_marked = 0;
+    marks->bits = calloc((marks->num_states + 63) / 64, sizeof(uint64_t));
+    if (!marks->bits) {
+        fprintf(stderr, "Error: Failed to allocate memory for Grover mark set\n");
+        free(marks);
+        return NULL;
+    }
+    
+    return marks;
+}
+
+GroverMarkSet* quantum_grover_marks_from_predicate(int num_qubits, GroverPredicate predicate, void *context) {
+    if (!predicate) {
+        fprintf(stderr, "Error: Null Grover predicate\n");
+        return NULL;
+    }
+    
+    GroverMarkSet *marks = quantum_grover_marks_create(num_qubits);
+    if (!marks) return NULL;
+    
+    int num_blocks = (marks->num_states + GROVER_PREDICATE_BLOCK - 1) / GROVER_PREDICATE_BLOCK;
+    int total = 0;
+    
+    /* Blocks cover whole 64-bit words, so threads never share a word */
+    #pragma omp parallel for schedule(dynamic) reduction(+:total)
+    for (int block = 0; block < num_blocks; block++) {
+        unsigned char marked[GROVER_PREDICATE_BLOCK] = {0};
+        int first = block * GROVER_PREDICATE_BLOCK;
+        int count = marks->num_states - first;
+        if (count > GROVER_PREDICATE_BLOCK) count = GROVER_PREDICATE_BLOCK;
+        
+        predicate(first, count, marked, context);
+        
+        for (int k = 0; k < count; k++) {
+            if (marked[k]) {
+                int index = first + k;
+                marks->bits[index >> 6] |= (uint64_t)1 << (index & 63);
+                total++;
+            }
+        }
+    }
+    
+    marks->num_marked = total;
+    return marks;
+}
+
+void quantum_grover_marks_destroy(GroverMarkSet *marks) {
+    if (marks) {
+        free(marks->bits);
+        free(marks);
+    }
+}
+
+void quantum_grover_marks_add(GroverMarkSet *marks, int index) {
+    if (!marks || index < 0 || index >= marks->num_states) {
+        fprintf(stderr, "Error: Invalid state index\n");
+        return;
+    }
+    if (!is_marked(marks->bits, index)) {
+        marks->bits[index >> 6] |= (uint64_t)1 << (index & 63);
+        marks->num_marked++;
+    }
+}
+
+int quantum_grover_marks_contains(const GroverMarkSet *marks, int index) {
+    if (!marks || index < 0 || index >= marks->num_states) return 0;
+    return is_marked(marks->bits, index);
+}
+
+// =============================================================================
+// GROVER ENGINE
+// =============================================================================
+
+int quantum_grover_optimal_iterations(int num_states, int num_marked) {
+    if (num_marked <= 0 || num_marked >= num_states) return 0;
+    
+    /* Each iteration rotates by 2θ with sin θ = sqrt(M/N); stop nearest π/2 */
+    double theta = asin(sqrt((double)num_marked / num_states));
+    int iterations = (int)floor(M_PI / (4.0 * theta));
+    return iterations;
+}
+
+double quantum_grover_marked_probability(const QuantumState *state, const GroverMarkSet *marks) {
+    if (!state || !marks || marks->num_states != state->num_states) return 0.0;
+    
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0.0;
+    
+    double probability = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:probability) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int i = 0; i < state->num_states; i++) {
+        if (is_marked(marks->bits, i)) {
+            probability += complex_kernel_magnitude_squared(amplitudes[i]);
+        }
+    }
+    quantum_state_release_amplitudes(state, scratch);
+    return probability;
+}
+
+void quantum_grover_iterate(QuantumState *state, const GroverMarkSet *marks, int iterations) {
+    if (!state || !marks) {
+        fprintf(stderr, "Error: Null state or mark set\n");
+        return;
+    }
+    if (marks->num_states != state->num_states) {
+        fprintf(stderr, "Error: Mark set and state have different numbers of qubits\n");
+        return;
+    }
+    if (iterations <= 0) return;
+    
+    quantum_state_materialise(state);
+    Complex *amplitudes = state->amplitudes;
+    const uint64_t *bits = marks->bits;
+    int num_states = state->num_states;
+    
+    /* Sum of the oracle-applied amplitudes Σ s_i a_i, s_i = -1 on marked states */
+    double sum_real = 0.0, sum_imag = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:sum_real, sum_imag) if (num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int i = 0; i < num_states; i++) {
+        double sign = 1.0 - 2.0 * is_marked(bits, i);
+        sum_real += sign * amplitudes[i].real;
+        sum_imag += sign * amplitudes[i].imag;
+    }
+    
+    /* Oracle and diffusion fused: a'_i = 2·mean - s_i a_i, while the same
+     * pass accumulates the oracle-applied sum for the next iteration */
+    for (int iter = 0; iter < iterations; iter++) {
+        double twice_mean_real = 2.0 * sum_real / num_states;
+        double twice_mean_imag = 2.0 * sum_imag / num_states;
+        double next_real = 0.0, next_imag = 0.0;
+        
+        #pragma omp parallel for schedule(static) reduction(+:next_real, next_imag) if (num_states >= QUANTUM_PARALLEL_THRESHOLD)
+        for (int i = 0; i < num_states; i++) {
+            double sign = 1.0 - 2.0 * is_marked(bits, i);
+            double real = twice_mean_real - sign * amplitudes[i].real;
+            double imag = twice_mean_imag - sign * amplitudes[i].imag;
+            amplitudes[i].real = real;
+            amplitudes[i].imag = imag;
+            next_real += sign * real;
+            next_imag += sign * imag;
+        }
+        
+        sum_real = next_real;
+        sum_imag = next_imag;
+    }
+}
+
+/* One round: uniform superposition, k iterations, measure */
+static int grover_round(QuantumState *state, const GroverMarkSet *marks, int iterations, GroverResult *result) {
+    quantum_state_initialise_equal_superposition(state);
+    quantum_grover_iterate(state, marks, iterations);
+    
+    result->success_probability = quantum_grover_marked_probability(state, marks);
+    result->iterations += iterations;
+    result->rounds++;
+    result->result = quantum_state_measure_all(state);
+    result->found = is_marked(marks->bits, result->result);
+    return result->found;
+}
+
+GroverResult quantum_grover_search(QuantumState *state, const GroverMarkSet *marks, int num_marked) {
+    GroverResult result = {0, -1, 0, 0, 0.0};
+    
+    if (!state || !marks) {
+        fprintf(stderr, "Error: Null state or mark set\n");
+        return result;
+    }
+    if (marks->num_states != state->num_states) {
+        fprintf(stderr, "Error: Mark set and state have different numbers of qubits\n");
+        return result;
+    }
+    
+    int num_states = state->num_states;
+    
+    if (num_marked != GROVER_COUNT_UNKNOWN) {
+        if (num_marked <= 0) return result;
+        grover_round(state, marks, quantum_grover_optimal_iterations(num_states, num_marked), &result);
+        return result;
+    }
+    
+    /* Unknown count: exponential search (Boyer, Brassard, Høyer, Tapp).
+     * Random iteration counts below a bound growing by 6/5 per round give
+     * O(sqrt(N/M)) expected iterations; the budget ends the search when
+     * there are no solutions. */
+    double bound = 1.0;
+    double max_bound = sqrt((double)num_states);
+    int budget = (int)(9.0 * max_bound) + 1;
+    
+    while (result.iterations <= budget) {
+        int iterations = quantum_utils_random_int(0, (int)ceil(bound) - 1);
+        if (grover_round(state, marks, iterations, &result)) break;
+        
+        bound *= 6.0 / 5.0;
+        if (bound > max_bound) bound = max_bound;
+    }
+    
+    return result;
+}
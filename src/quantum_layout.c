@@ -0,0 +1,77 @@
+#include "quantum_layout.h"
+#include <limits.h>
+
+void quantum_layout_init(QuantumLayout *layout, int num_qubits, int local,
+                         LayoutSwapFunction swap, void *context) {
+    layout->num_qubits = num_qubits;
+    layout->local = local;
+    layout->swap = swap;
+    layout->context = context;
+    for (int q = 0; q < num_qubits; q++) {
+        layout->physical[q] = q;
+        layout->occupant[q] = q;
+    }
+}
+
+int quantum_layout_is_local(const QuantumLayout *layout, const QuantumGate *gate) {
+    return layout->physical[gate->qubit1] < layout->local &&
+           (gate->qubit2 < 0 || layout->physical[gate->qubit2] < layout->local);
+}
+
+int quantum_layout_swap(QuantumLayout *layout, int p1, int p2) {
+    if (p1 > p2) {
+        int temp = p1;
+        p1 = p2;
+        p2 = temp;
+    }
+    if (!layout->swap(layout->context, p1, p2)) return 0;
+
+    int q1 = layout->occupant[p1], q2 = layout->occupant[p2];
+    layout->occupant[p1] = q2;
+    layout->occupant[p2] = q1;
+    layout->physical[q1] = p2;
+    layout->physical[q2] = p1;
+    return 1;
+}
+
+/* Bring a gate's global qubits into local positions, evicting the local
+ * qubits whose next use lies furthest ahead */
+int quantum_layout_localise(QuantumLayout *layout, const QuantumGate *gates, int num_gates, int index) {
+    const QuantumGate *gate = &gates[index];
+    int operands[2] = {gate->qubit1, gate->qubit2};
+    int n = layout->num_qubits;
+
+    /* The scan stops once every qubit's next use is known */
+    int next_use[MAX_MAPPED_QUBITS];
+    for (int q = 0; q < n; q++) next_use[q] = INT_MAX;
+    unsigned int pending = (1u << n) - 1;
+    for (int j = index; j < num_gates && pending; j++) {
+        unsigned int used = quantum_circuit_gate_qubits(&gates[j], n) & pending;
+        for (int q = 0; q < n; q++) {
+            if (used & (1u << q)) next_use[q] = j;
+        }
+        pending &= ~used;
+    }
+
+    for (int k = 0; k < 2; k++) {
+        int q = operands[k];
+        if (q < 0 || layout->physical[q] < layout->local) continue;
+
+        int victim = -1;
+        for (int p = 0; p < layout->local; p++) {
+            int occupant = layout->occupant[p];
+            if (occupant == operands[0] || occupant == operands[1]) continue;
+            if (victim < 0 || next_use[occupant] > next_use[layout->occupant[victim]]) victim = p;
+        }
+        if (!quantum_layout_swap(layout, victim, layout->physical[q])) return 0;
+    }
+    return 1;
+}
+
+/* Deterministic, so ranks restoring the same layout pair their swaps up */
+int quantum_layout_restore(QuantumLayout *layout) {
+    for (int p = 0; p < layout->num_qubits; p++) {
+        if (layout->occupant[p] != p && !quantum_layout_swap(layout, p, layout->physical[p])) return 0;
+    }
+    return 1;
+}
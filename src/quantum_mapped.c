@@ -0,0 +1,242 @@
+#include "quantum_mapped.h"
+#include "quantum_layout.h"
+#include "quantum_gates.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+typedef struct {
+    QuantumState *state;
+    QuantumLayout layout;               /* Local positions address within a chunk */
+    int num_chunks;
+    size_t chunk_states;
+    size_t state_bytes;
+    MappedExecutionStats *stats;
+    int report;
+} MappedExecutor;
+
+static int is_whole_state_gate(GateType type) {
+    return type == GATE_MEASURE || type == GATE_MEASURE_ALL ||
+           type == GATE_QFT || type == GATE_IQFT || type == GATE_ORACLE;
+}
+
+static Complex* chunk_data(const MappedExecutor *ex, int chunk) {
+    return ex->state->amplitudes + (size_t)chunk * ex->chunk_states;
+}
+
+/* Page-cache hints only matter (and are only legal) for page-aligned file-backed chunks */
+static void advise_chunk(const MappedExecutor *ex, int chunk, int advice) {
+    size_t bytes = ex->chunk_states * sizeof(Complex);
+    if (ex->state->storage != QUANTUM_STORAGE_MAPPED || chunk < 0 || chunk >= ex->num_chunks ||
+        bytes % (size_t)sysconf(_SC_PAGESIZE) != 0) {
+        return;
+    }
+    madvise(chunk_data(ex, chunk), bytes, advice);
+}
+
+// =============================================================================
+// STREAMING PASSES
+// =============================================================================
+
+static int local_pass(MappedExecutor *ex, const QuantumGate *gates, int first, int last) {
+    QuantumState view;
+    view.num_qubits = ex->layout.local;
+    view.num_states = (int)ex->chunk_states;
+    view.storage = QUANTUM_STORAGE_HEAP;
+    view.form = QUANTUM_FORM_DENSE;
+    view.factors = NULL;
+    view.snapshot = NULL;
+
+    for (int c = 0; c < ex->num_chunks; c++) {
+        advise_chunk(ex, c + 1, MADV_WILLNEED);
+        view.amplitudes = chunk_data(ex, c);
+
+        for (int g = first; g < last; g++) {
+            QuantumGate gate = gates[g];
+            gate.qubit1 = ex->layout.physical[gate.qubit1];
+            if (gate.qubit2 >= 0) gate.qubit2 = ex->layout.physical[gate.qubit2];
+            if (!quantum_circuit_apply_gate(&gate, &view, NULL)) return 0;
+        }
+        advise_chunk(ex, c, MADV_DONTNEED);
+    }
+
+    ex->stats->passes++;
+    ex->stats->bytes_streamed += 2 * (long long)ex->state_bytes;
+    if (ex->report) {
+        printf("Pass %d: gates %d-%d over %d chunk(s)\n", ex->stats->passes, first, last - 1, ex->num_chunks);
+    }
+    return 1;
+}
+
+/* Exchange a local position with a global one: chunk pairs differing in the global bit trade halves */
+static void swap_local_global(MappedExecutor *ex, int local, int global) {
+    int global_bit = 1 << (global - ex->layout.local);
+    size_t local_mask = (size_t)1 << local;
+    long long half = (long long)(ex->chunk_states / 2);
+
+    for (int c = 0; c < ex->num_chunks; c++) {
+        if (c & global_bit) continue;
+        Complex *low = chunk_data(ex, c);
+        Complex *high = chunk_data(ex, c | global_bit);
+
+        #pragma omp parallel for
+        for (long long t = 0; t < half; t++) {
+            size_t k = (((size_t)t >> local) << (local + 1)) | ((size_t)t & (local_mask - 1));
+            Complex temp = low[k | local_mask];
+            low[k | local_mask] = high[k];
+            high[k] = temp;
+        }
+        advise_chunk(ex, c, MADV_DONTNEED);
+        advise_chunk(ex, c | global_bit, MADV_DONTNEED);
+    }
+    ex->stats->bytes_streamed += 2 * (long long)ex->state_bytes;
+}
+
+/* Two global positions only reorder whole chunks */
+static void swap_global_global(MappedExecutor *ex, int global1, int global2) {
+    int bit1 = 1 << (global1 - ex->layout.local);
+    int bit2 = 1 << (global2 - ex->layout.local);
+    long long count = (long long)ex->chunk_states;
+
+    for (int c = 0; c < ex->num_chunks; c++) {
+        if (!(c & bit1) || (c & bit2)) continue;
+        Complex *a = chunk_data(ex, c);
+        Complex *b = chunk_data(ex, c ^ bit1 ^ bit2);
+
+        #pragma omp parallel for
+        for (long long k = 0; k < count; k++) {
+            Complex temp = a[k];
+            a[k] = b[k];
+            b[k] = temp;
+        }
+    }
+    ex->stats->bytes_streamed += (long long)ex->state_bytes;
+}
+
+static void swap_local_local(MappedExecutor *ex, int local1, int local2) {
+    QuantumState view;
+    view.num_qubits = ex->layout.local;
+    view.num_states = (int)ex->chunk_states;
+    view.storage = QUANTUM_STORAGE_HEAP;
+    view.form = QUANTUM_FORM_DENSE;
+    view.factors = NULL;
+    view.snapshot = NULL;
+
+    for (int c = 0; c < ex->num_chunks; c++) {
+        view.amplitudes = chunk_data(ex, c);
+        gate_swap(&view, local1, local2);
+    }
+    ex->stats->bytes_streamed += 2 * (long long)ex->state_bytes;
+}
+
+/* Layout callback for positions p1 < p2 */
+static int physical_swap(void *context, int p1, int p2) {
+    MappedExecutor *ex = context;
+    int local = ex->layout.local;
+
+    if (p2 < local) {
+        swap_local_local(ex, p1, p2);
+    } else if (p1 < local) {
+        swap_local_global(ex, p1, p2);
+    } else {
+        swap_global_global(ex, p1, p2);
+    }
+
+    ex->stats->swap_passes++;
+    if (ex->report) {
+        printf("Swap pass %d: qubit %d -> position %d, qubit %d -> position %d\n",
+               ex->stats->swap_passes, ex->layout.occupant[p1], p2, ex->layout.occupant[p2], p1);
+    }
+    return 1;
+}
+
+// =============================================================================
+// EXECUTION
+// =============================================================================
+
+int quantum_mapped_execute(const QuantumCircuit *circuit, QuantumState *state,
+                           const MappedExecutionOptions *options, MappedExecutionStats *stats) {
+    if (!circuit || !state) {
+        fprintf(stderr, "Error: Null circuit or state\n");
+        return 0;
+    }
+    if (circuit->num_qubits != state->num_qubits) {
+        fprintf(stderr, "Error: Circuit and state have different numbers of qubits\n");
+        return 0;
+    }
+
+    int n = state->num_qubits;
+    quantum_state_materialise(state);
+    for (int i = 0; i < circuit->num_gates; i++) {
+        const QuantumGate *gate = &circuit->gates[i];
+        if (!is_whole_state_gate(gate->type) &&
+            (gate->qubit1 < 0 || gate->qubit1 >= n || gate->qubit2 < -1 || gate->qubit2 >= n)) {
+            fprintf(stderr, "Error: Gate %d acts on a qubit out of range [0, %d)\n", i, n);
+            return 0;
+        }
+    }
+
+    MappedExecutionStats local_stats;
+    MappedExecutor ex;
+    memset(&ex, 0, sizeof(ex));
+    ex.state = state;
+    ex.stats = stats ? stats : &local_stats;
+    ex.report = options ? options->report_progress : 0;
+    memset(ex.stats, 0, sizeof(MappedExecutionStats));
+
+    /* Two-qubit gates need two chunk positions */
+    int local = (options && options->local_qubits > 0) ? options->local_qubits : MAPPED_DEFAULT_LOCAL_QUBITS;
+    if (local > n) local = n;
+    if (local < 2) local = n < 2 ? n : 2;
+
+    quantum_layout_init(&ex.layout, n, local, physical_swap, &ex);
+    ex.chunk_states = (size_t)1 << local;
+    ex.num_chunks = 1 << (n - local);
+    ex.state_bytes = (size_t)state->num_states * sizeof(Complex);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int success = 1;
+    int i = 0;
+    while (success && i < circuit->num_gates) {
+        const QuantumGate *gate = &circuit->gates[i];
+
+        if (is_whole_state_gate(gate->type)) {
+            quantum_layout_restore(&ex.layout);
+            success = quantum_circuit_apply_gate(gate, state, NULL);
+            ex.stats->global_gates++;
+            ex.stats->gates++;
+            i++;
+            continue;
+        }
+
+        if (!quantum_layout_is_local(&ex.layout, gate)) {
+            quantum_layout_localise(&ex.layout, circuit->gates, circuit->num_gates, i);
+        }
+
+        int last = i;
+        while (last < circuit->num_gates && !is_whole_state_gate(circuit->gates[last].type) &&
+               quantum_layout_is_local(&ex.layout, &circuit->gates[last])) {
+            last++;
+        }
+        success = local_pass(&ex, circuit->gates, i, last);
+        ex.stats->gates += last - i;
+        i = last;
+    }
+    quantum_layout_restore(&ex.layout);
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ex.stats->seconds = (end.tv_sec - start.tv_sec) + 1e-9 * (end.tv_nsec - start.tv_nsec);
+
+    if (ex.report) {
+        double megabytes = ex.stats->bytes_streamed / 1e6;
+        printf("Out-of-core execution: %lld gates, %d passes, %d swap passes, %.1f MB streamed in %.2f s (%.1f MB/s)\n",
+               ex.stats->gates, ex.stats->passes, ex.stats->swap_passes, megabytes, ex.stats->seconds,
+               ex.stats->seconds > 0.0 ? megabytes / ex.stats->seconds : 0.0);
+    }
+    return success;
+}
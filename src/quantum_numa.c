@@ -0,0 +1,156 @@
+#include "quantum_numa.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define NUMA_MAX_NODES 64
+#define NUMA_PAGE_BYTES 4096
+#define NUMA_HUGE_PAGE_BYTES (2u << 20)
+#define NUMA_MPOL_INTERLEAVE 3  /* From <linux/mempolicy.h> */
+
+static NumaPolicy numa_policy = NUMA_POLICY_FIRST_TOUCH;
+
+void quantum_numa_set_policy(NumaPolicy policy) {
+    numa_policy = policy;
+}
+
+NumaPolicy quantum_numa_get_policy(void) {
+    return numa_policy;
+}
+
+/* Parses the kernel's online node list ("0", "0-1", "0,2-3") into a mask */
+static unsigned long long online_nodes(void) {
+    unsigned long long mask = 0;
+    char list[256];
+    FILE *file = fopen("/sys/devices/system/node/online", "r");
+
+    if (!file) return 1;
+    if (fgets(list, sizeof(list), file)) {
+        char *p = list;
+        while (*p >= '0' && *p <= '9') {
+            long first = strtol(p, &p, 10), last = first;
+            if (*p == '-') last = strtol(p + 1, &p, 10);
+            for (long node = first; node <= last && node < NUMA_MAX_NODES; node++) {
+                mask |= 1ULL << node;
+            }
+            if (*p == ',') p++;
+        }
+    }
+    fclose(file);
+    return mask ? mask : 1;
+}
+
+int quantum_numa_num_nodes(void) {
+    unsigned long long mask = online_nodes();
+    int count = 0;
+    while (mask) {
+        count += (int)(mask & 1);
+        mask >>= 1;
+    }
+    return count;
+}
+
+static size_t huge_mapping_bytes(size_t bytes) {
+    return (bytes + NUMA_HUGE_PAGE_BYTES - 1) / NUMA_HUGE_PAGE_BYTES * NUMA_HUGE_PAGE_BYTES;
+}
+
+/* Anonymous mapping on a huge-page boundary, so the kernel can back it with
+ * 2 MB pages and a large state needs 512x fewer TLB entries */
+static void* map_huge(size_t bytes) {
+    size_t length = huge_mapping_bytes(bytes);
+    char *base = mmap(NULL, length + NUMA_HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+
+    size_t lead = (NUMA_HUGE_PAGE_BYTES - (uintptr_t)base % NUMA_HUGE_PAGE_BYTES) % NUMA_HUGE_PAGE_BYTES;
+    if (lead > 0) munmap(base, lead);
+    munmap(base + lead + length, NUMA_HUGE_PAGE_BYTES - lead);
+#ifdef MADV_HUGEPAGE
+    madvise(base + lead, length, MADV_HUGEPAGE);
+#endif
+    return base + lead;
+}
+
+Complex* quantum_numa_alloc_amplitudes(size_t count) {
+    size_t bytes = count * sizeof(Complex);
+    void *amplitudes = NULL;
+
+    if (bytes >= NUMA_HUGE_PAGE_BYTES) {
+        amplitudes = map_huge(bytes);
+        if (!amplitudes) return NULL;
+    } else if (posix_memalign(&amplitudes, NUMA_PAGE_BYTES, bytes) != 0) {
+        return NULL;
+    }
+
+    /* Only the placement policy is set here; pages are placed when first touched */
+    if (numa_policy == NUMA_POLICY_INTERLEAVE && bytes >= NUMA_PAGE_BYTES && quantum_numa_num_nodes() > 1) {
+        unsigned long nodes = (unsigned long)online_nodes();
+        syscall(SYS_mbind, amplitudes, bytes / NUMA_PAGE_BYTES * NUMA_PAGE_BYTES,
+                NUMA_MPOL_INTERLEAVE, &nodes, (unsigned long)(sizeof(nodes) * 8 + 1), 0UL);
+    }
+    return amplitudes;
+}
+
+void quantum_numa_free_amplitudes(Complex *amplitudes, size_t count) {
+    size_t bytes = count * sizeof(Complex);
+    if (!amplitudes) return;
+
+    if (bytes >= NUMA_HUGE_PAGE_BYTES) {
+        munmap(amplitudes, huge_mapping_bytes(bytes));
+    } else {
+        free(amplitudes);
+    }
+}
+
+int quantum_numa_pin_threads(void) {
+    cpu_set_t allowed;
+    int cpus[CPU_SETSIZE];
+    int num_cpus = 0;
+    int pinned = 0;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) cpus[num_cpus++] = cpu;
+    }
+    if (num_cpus == 0) return 0;
+
+#ifdef _OPENMP
+    /* Spread rather than pack, so threads cover every socket before sharing one */
+    #pragma omp parallel reduction(+:pinned)
+    {
+        int thread = omp_get_thread_num();
+        int num_threads = omp_get_num_threads();
+        cpu_set_t target;
+
+        CPU_ZERO(&target);
+        CPU_SET(cpus[(long)thread * num_cpus / num_threads], &target);
+        if (sched_setaffinity(0, sizeof(target), &target) == 0) pinned++;
+    }
+#endif
+    return pinned;
+}
+
+void quantum_numa_initialise(void) {
+    const char *policy = getenv("QUANTUM_NUMA_POLICY");
+    const char *pin = getenv("QUANTUM_PIN_THREADS");
+
+    if (policy && strcmp(policy, "interleave") == 0) {
+        quantum_numa_set_policy(NUMA_POLICY_INTERLEAVE);
+    } else if (policy && strcmp(policy, "first-touch") == 0) {
+        quantum_numa_set_policy(NUMA_POLICY_FIRST_TOUCH);
+    } else if (policy) {
+        fprintf(stderr, "Error: Unknown QUANTUM_NUMA_POLICY '%s', using first-touch\n", policy);
+    }
+
+    if (pin && strcmp(pin, "1") == 0 && !getenv("OMP_PROC_BIND")) {
+        quantum_numa_pin_threads();
+    }
+}
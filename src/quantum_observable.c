@@ -0,0 +1,297 @@
+#include "quantum_observable.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Terms accumulated per sweep; larger groups take several sweeps */
+#define TERMS_PER_PASS 32
+
+/*
+ * P = i^|x&z| X^x Z^z maps |j⟩ to i^|x&z| (-1)^|j&z| |j⊕x⟩, so
+ * ⟨ψ|P|ψ⟩ = Re( i^|x&z| Σ_j (-1)^|j&z| conj(ψ_{j⊕x}) ψ_j ).
+ * All terms sharing x reuse the same products conj(ψ_{j⊕x}) ψ_j.
+ */
+static void evaluate_terms(const Complex *amplitudes, int num_states, uint32_t x_mask,
+                           const PauliTerm *terms, int count, double *values) {
+    double sum_real[TERMS_PER_PASS] = {0};
+    double sum_imag[TERMS_PER_PASS] = {0};
+    
+    #pragma omp parallel
+    {
+        double local_real[TERMS_PER_PASS] = {0};
+        double local_imag[TERMS_PER_PASS] = {0};
+        
+        #pragma omp for schedule(static)
+        for (int j = 0; j < num_states; j++) {
+            Complex a = amplitudes[j];
+            Complex b = amplitudes[j ^ x_mask];
+            double real = b.real * a.real + b.imag * a.imag;  /* conj(b) * a */
+            double imag = b.real * a.imag - b.imag * a.real;
+            
+            for (int t = 0; t < count; t++) {
+                double sign = 1.0 - 2.0 * (__builtin_popcount((uint32_t)j & terms[t].z_mask) & 1);
+                local_real[t] += sign * real;
+                local_imag[t] += sign * imag;
+            }
+        }
+        
+        #pragma omp critical
+        for (int t = 0; t < count; t++) {
+            sum_real[t] += local_real[t];
+            sum_imag[t] += local_imag[t];
+        }
+    }
+    
+    for (int t = 0; t < count; t++) {
+        double value;
+        switch (__builtin_popcount(x_mask & terms[t].z_mask) & 3) {
+            case 0: value = sum_real[t]; break;
+            case 1: value = -sum_imag[t]; break;
+            case 2: value = -sum_real[t]; break;
+            default: value = sum_imag[t]; break;
+        }
+        values[t] = terms[t].coefficient * value;
+    }
+}
+
+static int validate_term(int num_qubits, PauliTerm term) {
+    uint32_t valid = (num_qubits >= 32) ? 0xFFFFFFFFu : ((1u << num_qubits) - 1);
+    if ((term.x_mask | term.z_mask) & ~valid) {
+        fprintf(stderr, "Error: Pauli term acts on qubits outside [0, %d)\n", num_qubits);
+        return 0;
+    }
+    return 1;
+}
+
+// =============================================================================
+// OBSERVABLE MANAGEMENT
+// =============================================================================
+
+typedef struct {
+    PauliTerm term;
+    int index;
+} IndexedTerm;
+
+static int compare_indexed_terms(const void *a, const void *b) {
+    const IndexedTerm *ta = a;
+    const IndexedTerm *tb = b;
+    if (ta->term.x_mask != tb->term.x_mask) return (ta->term.x_mask < tb->term.x_mask) ? -1 : 1;
+    return ta->index - tb->index;
+}
+
+PauliObservable* quantum_observable_create(int num_qubits, const PauliTerm *terms, int num_terms) {
+    if (num_qubits < 1 || num_qubits > MAX_QUBITS) {
+        fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_QUBITS);
+        return NULL;
+    }
+    if (!terms || num_terms < 1) {
+        fprintf(stderr, "Error: Observable needs at least one Pauli term\n");
+        return NULL;
+    }
+    for (int t = 0; t < num_terms; t++) {
+        if (!validate_term(num_qubits, terms[t])) return NULL;
+    }
+    
+    PauliObservable *observable = calloc(1, sizeof(PauliObservable));
+    if (!observable) {
+        fprintf(stderr, "Error: Failed to allocate memory for observable\n");
+        return NULL;
+    }
+    
+    observable->num_qubits = num_qubits;
+    observable->num_terms = num_terms;
+    observable->terms = malloc(num_terms * sizeof(PauliTerm));
+    observable->term_order = malloc(num_terms * sizeof(int));
+    observable->group_start = malloc((num_terms + 1) * sizeof(int));
+    if (!observable->terms || !observable->term_order || !observable->group_start) {
+        fprintf(stderr, "Error: Failed to allocate memory for observable\n");
+        quantum_observable_destroy(observable);
+        return NULL;
+    }
+    
+    IndexedTerm *sorted = malloc(num_terms * sizeof(IndexedTerm));
+    if (!sorted) {
+        fprintf(stderr, "Error: Failed to allocate memory for observable\n");
+        quantum_observable_destroy(observable);
+        return NULL;
+    }
+    
+    /* Group terms by X mask, keeping the caller's order within a group */
+    for (int t = 0; t < num_terms; t++) {
+        sorted[t].term = terms[t];
+        sorted[t].index = t;
+    }
+    qsort(sorted, num_terms, sizeof(IndexedTerm), compare_indexed_terms);
+    
+    observable->num_groups = 0;
+    for (int t = 0; t < num_terms; t++) {
+        observable->terms[t] = sorted[t].term;
+        observable->term_order[t] = sorted[t].index;
+        if (t == 0 || observable->terms[t].x_mask != observable->terms[t - 1].x_mask) {
+            observable->group_start[observable->num_groups++] = t;
+        }
+    }
+    observable->group_start[observable->num_groups] = num_terms;
+    
+    free(sorted);
+    return observable;
+}
+
+void quantum_observable_destroy(PauliObservable *observable) {
+    if (observable) {
+        free(observable->terms);
+        free(observable->term_order);
+        free(observable->group_start);
+        free(observable);
+    }
+}
+
+// =============================================================================
+// EXPECTATION VALUES
+// =============================================================================
+
+double quantum_pauli_expectation(const QuantumState *state, PauliTerm term) {
+    if (!state || !validate_term(state->num_qubits, term)) return 0.0;
+    
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0.0;
+    
+    double value;
+    evaluate_terms(amplitudes, state->num_states, term.x_mask, &term, 1, &value);
+    quantum_state_release_amplitudes(state, scratch);
+    return value;
+}
+
+/* Evaluates every group; stores per-term values if requested and returns the sum */
+static double evaluate_observable(const PauliObservable *observable, const QuantumState *state, double *values) {
+    double group_values[TERMS_PER_PASS];
+    double total = 0.0;
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0.0;
+    
+    for (int g = 0; g < observable->num_groups; g++) {
+        for (int first = observable->group_start[g]; first < observable->group_start[g + 1]; first += TERMS_PER_PASS) {
+            int count = observable->group_start[g + 1] - first;
+            if (count > TERMS_PER_PASS) count = TERMS_PER_PASS;
+            
+            evaluate_terms(amplitudes, state->num_states, observable->terms[first].x_mask,
+                           &observable->terms[first], count, group_values);
+            for (int t = 0; t < count; t++) {
+                if (values) values[observable->term_order[first + t]] = group_values[t];
+                total += group_values[t];
+            }
+        }
+    }
+    
+    quantum_state_release_amplitudes(state, scratch);
+    return total;
+}
+
+static int validate_observable_state(const PauliObservable *observable, const QuantumState *state) {
+    if (!observable || !state) {
+        fprintf(stderr, "Error: Null observable or state\n");
+        return 0;
+    }
+    if (observable->num_qubits != state->num_qubits) {
+        fprintf(stderr, "Error: Observable and state have different numbers of qubits\n");
+        return 0;
+    }
+    return 1;
+}
+
+void quantum_observable_term_expectations(const PauliObservable *observable, const QuantumState *state, double *values) {
+    if (!validate_observable_state(observable, state) || !values) return;
+    evaluate_observable(observable, state, values);
+}
+
+double quantum_observable_expectation(const PauliObservable *observable, const QuantumState *state) {
+    if (!validate_observable_state(observable, state)) return 0.0;
+    return evaluate_observable(observable, state, NULL);
+}
+
+// =============================================================================
+// MATRIX ELEMENTS AND APPLICATION
+// =============================================================================
+
+/* i^k for k = 0..3 */
+static Complex power_of_i(int k) {
+    static const double real[4] = {1.0, 0.0, -1.0, 0.0};
+    static const double imag[4] = {0.0, 1.0, 0.0, -1.0};
+    return complex_create(real[k & 3], imag[k & 3]);
+}
+
+Complex quantum_pauli_matrix_element(const QuantumState *bra, PauliTerm term, const QuantumState *ket) {
+    if (!bra || !ket || bra->num_qubits != ket->num_qubits || !validate_term(ket->num_qubits, term)) {
+        fprintf(stderr, "Error: Invalid states for Pauli matrix element\n");
+        return complex_create(0.0, 0.0);
+    }
+    
+    /* ⟨a|P|b⟩ = i^|x&z| Σ_j (-1)^|j&z| conj(a_{j⊕x}) b_j */
+    Complex *bra_scratch, *ket_scratch;
+    const Complex *bra_amplitudes = quantum_state_read_amplitudes(bra, &bra_scratch);
+    const Complex *ket_amplitudes = quantum_state_read_amplitudes(ket, &ket_scratch);
+    if (!bra_amplitudes || !ket_amplitudes) {
+        quantum_state_release_amplitudes(bra, bra_scratch);
+        quantum_state_release_amplitudes(ket, ket_scratch);
+        return complex_create(0.0, 0.0);
+    }
+    
+    double sum_real = 0.0, sum_imag = 0.0;
+    #pragma omp parallel for reduction(+:sum_real, sum_imag)
+    for (int j = 0; j < ket->num_states; j++) {
+        Complex a = bra_amplitudes[j ^ term.x_mask];
+        Complex b = ket_amplitudes[j];
+        double sign = 1.0 - 2.0 * (__builtin_popcount((uint32_t)j & term.z_mask) & 1);
+        sum_real += sign * (a.real * b.real + a.imag * b.imag);
+        sum_imag += sign * (a.real * b.imag - a.imag * b.real);
+    }
+    
+    quantum_state_release_amplitudes(bra, bra_scratch);
+    quantum_state_release_amplitudes(ket, ket_scratch);
+    
+    Complex phase = power_of_i(__builtin_popcount(term.x_mask & term.z_mask));
+    Complex value = complex_multiply(phase, complex_create(sum_real, sum_imag));
+    return complex_create(term.coefficient * value.real, term.coefficient * value.imag);
+}
+
+int quantum_observable_apply(const PauliObservable *observable, const QuantumState *input, QuantumState *output) {
+    if (!validate_observable_state(observable, input)) return 0;
+    if (!output || output == input || output->num_qubits != input->num_qubits) {
+        fprintf(stderr, "Error: Observable output must be a distinct state of the same size\n");
+        return 0;
+    }
+    
+    /* (Pψ)_k = i^|x&z| (-1)^|(k⊕x)&z| ψ_{k⊕x}; each output amplitude is
+     * written once, so the pass is gather-only and parallel */
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(input, &scratch);
+    if (!amplitudes) return 0;
+    
+    output->form = QUANTUM_FORM_DENSE;
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < input->num_states; k++) {
+        double real = 0.0, imag = 0.0;
+        
+        for (int t = 0; t < observable->num_terms; t++) {
+            const PauliTerm *term = &observable->terms[t];
+            int j = k ^ (int)term->x_mask;
+            Complex a = amplitudes[j];
+            double weight = term->coefficient *
+                            (1.0 - 2.0 * (__builtin_popcount((uint32_t)j & term->z_mask) & 1));
+            
+            switch (__builtin_popcount(term->x_mask & term->z_mask) & 3) {
+                case 0: real += weight * a.real; imag += weight * a.imag; break;
+                case 1: real -= weight * a.imag; imag += weight * a.real; break;
+                case 2: real -= weight * a.real; imag -= weight * a.imag; break;
+                default: real += weight * a.imag; imag -= weight * a.real; break;
+            }
+        }
+        
+        output->amplitudes[k] = complex_create(real, imag);
+    }
+    
+    quantum_state_release_amplitudes(input, scratch);
+    return 1;
+}
@@ -0,0 +1,398 @@
+#include "quantum_optimise.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define OPTIMISE_ANGLE_TOLERANCE 1e-12
+
+// =============================================================================
+// PEEPHOLE
+// =============================================================================
+
+typedef enum {
+    BASIS_NONE,
+    BASIS_Z,     /* Diagonal in the computational basis on this qubit */
+    BASIS_X      /* Diagonal in the Hadamard basis on this qubit */
+} QubitBasis;
+
+static QubitBasis qubit_basis(const QuantumGate *gate, int qubit) {
+    switch (gate->type) {
+        case GATE_PAULI_Z:
+        case GATE_PHASE:
+        case GATE_ROTATION_Z:
+        case GATE_CZ:
+        case GATE_CONTROLLED_PHASE:
+            return BASIS_Z;
+        case GATE_PAULI_X:
+        case GATE_ROTATION_X:
+            return BASIS_X;
+        case GATE_CNOT:
+            return qubit == gate->qubit1 ? BASIS_Z : BASIS_X;
+        default:
+            return BASIS_NONE;
+    }
+}
+
+static int commutes(const QuantumGate *a, unsigned int mask_a, const QuantumGate *b, unsigned int mask_b) {
+    unsigned int shared = mask_a & mask_b;
+
+    for (int q = 0; shared; q++, shared >>= 1) {
+        if (!(shared & 1)) continue;
+        QubitBasis basis = qubit_basis(a, q);
+        if (basis == BASIS_NONE || basis != qubit_basis(b, q)) return 0;
+    }
+    return 1;
+}
+
+static int same_pair(const QuantumGate *a, const QuantumGate *b) {
+    return (a->qubit1 == b->qubit1 && a->qubit2 == b->qubit2) ||
+           (a->qubit1 == b->qubit2 && a->qubit2 == b->qubit1);
+}
+
+/* a followed by b is the identity */
+static int cancels(const QuantumGate *a, const QuantumGate *b) {
+    if (a->type != b->type) return 0;
+
+    switch (a->type) {
+        case GATE_PAULI_X:
+        case GATE_PAULI_Y:
+        case GATE_PAULI_Z:
+        case GATE_HADAMARD:
+            return a->qubit1 == b->qubit1;
+        case GATE_CNOT:
+            return a->qubit1 == b->qubit1 && a->qubit2 == b->qubit2;
+        case GATE_CZ:
+        case GATE_SWAP:
+            return same_pair(a, b);
+        default:
+            return 0;
+    }
+}
+
+/* a and b are the same fixed-angle rotation, so b's angle can absorb a's */
+static int mergeable(const QuantumGate *a, const QuantumGate *b) {
+    if (a->type != b->type || a->parameter_index >= 0 || b->parameter_index >= 0) return 0;
+
+    switch (a->type) {
+        case GATE_PHASE:
+        case GATE_ROTATION_X:
+        case GATE_ROTATION_Y:
+        case GATE_ROTATION_Z:
+            return a->qubit1 == b->qubit1;
+        case GATE_CONTROLLED_PHASE:
+            return same_pair(a, b);
+        default:
+            return 0;
+    }
+}
+
+/* Rotations repeat every 4*pi (2*pi is -I), phases every 2*pi */
+static int is_identity_rotation(const QuantumGate *gate) {
+    double period;
+
+    if (gate->parameter_index >= 0) return 0;
+    switch (gate->type) {
+        case GATE_PHASE:
+        case GATE_CONTROLLED_PHASE:
+            period = 2.0 * M_PI;
+            break;
+        case GATE_ROTATION_X:
+        case GATE_ROTATION_Y:
+        case GATE_ROTATION_Z:
+            period = 4.0 * M_PI;
+            break;
+        default:
+            return 0;
+    }
+
+    double remainder = fmod(fabs(gate->parameter), period);
+    return remainder < OPTIMISE_ANGLE_TOLERANCE || period - remainder < OPTIMISE_ANGLE_TOLERANCE;
+}
+
+/* One sweep over the live gates; returns whether anything changed */
+static int optimise_pass(QuantumCircuit *circuit, unsigned char *alive, const unsigned int *masks,
+                         OptimiseStats *stats) {
+    int changed = 0;
+
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (!alive[i]) continue;
+        QuantumGate *gate = &circuit->gates[i];
+
+        if (is_identity_rotation(gate)) {
+            alive[i] = 0;
+            stats->dropped++;
+            changed = 1;
+            continue;
+        }
+
+        for (int j = i + 1; j < circuit->num_gates; j++) {
+            if (!alive[j] || !(masks[i] & masks[j])) continue;
+            QuantumGate *next = &circuit->gates[j];
+
+            if (cancels(gate, next)) {
+                alive[i] = alive[j] = 0;
+                stats->cancelled += 2;
+                changed = 1;
+                break;
+            }
+            if (mergeable(gate, next)) {
+                next->parameter += gate->parameter;
+                alive[i] = 0;
+                stats->merged++;
+                changed = 1;
+                break;
+            }
+            if (!commutes(gate, masks[i], next, masks[j])) break;
+        }
+    }
+    return changed;
+}
+
+int quantum_optimise_circuit(QuantumCircuit *circuit, OptimiseStats *stats) {
+    OptimiseStats local;
+    unsigned char alive[MAX_GATES];
+    unsigned int masks[MAX_GATES];
+
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(OptimiseStats));
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return 0;
+    }
+
+    stats->gates_before = circuit->num_gates;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        alive[i] = 1;
+        masks[i] = quantum_circuit_gate_qubits(&circuit->gates[i], circuit->num_qubits);
+    }
+
+    do {
+        stats->passes++;
+    } while (optimise_pass(circuit, alive, masks, stats));
+
+    int kept = 0;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (alive[i]) circuit->gates[kept++] = circuit->gates[i];
+    }
+    circuit->num_gates = kept;
+    stats->gates_after = kept;
+
+    return stats->gates_before - kept;
+}
+
+// =============================================================================
+// LIGHT CONE
+// =============================================================================
+
+static int is_diagonal(GateType type) {
+    return type == GATE_PAULI_Z || type == GATE_PHASE || type == GATE_ROTATION_Z ||
+           type == GATE_CZ || type == GATE_CONTROLLED_PHASE;
+}
+
+static int is_measurement(GateType type) {
+    return type == GATE_MEASURE || type == GATE_MEASURE_ALL;
+}
+
+static unsigned int all_qubits(int num_qubits) {
+    return (unsigned int)(((unsigned long long)1 << num_qubits) - 1);
+}
+
+/* Qubits measured by any gate still alive (alive NULL for all gates) */
+static unsigned int measured_qubits(const QuantumCircuit *circuit, const unsigned char *alive) {
+    unsigned int measured = 0;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if ((!alive || alive[i]) && is_measurement(circuit->gates[i].type)) {
+            measured |= quantum_circuit_gate_qubits(&circuit->gates[i], circuit->num_qubits);
+        }
+    }
+    return measured;
+}
+
+/* Backward pass keeping the gates that can influence an observed outcome.
+ * Observed qubits that are never measured are read from the final state, so
+ * they are live from the end; measured ones become live at their measurement. */
+static int prune_light_cone(const QuantumCircuit *circuit, unsigned char *alive, unsigned int observed,
+                            LightConeStats *stats) {
+    unsigned int live = observed & ~measured_qubits(circuit, alive);
+    int removed = 0;
+
+    for (int i = circuit->num_gates - 1; i >= 0; i--) {
+        if (!alive[i]) continue;
+        const QuantumGate *gate = &circuit->gates[i];
+        unsigned int touched = quantum_circuit_gate_qubits(gate, circuit->num_qubits);
+
+        if (gate->type == GATE_MEASURE_ALL) {
+            live |= observed;
+            continue;
+        }
+        if (gate->type == GATE_MEASURE && (touched & observed)) {
+            live |= touched;
+            continue;
+        }
+        /* Unobserved measurements only matter while their collapse can reach a live qubit */
+        if (touched & live) {
+            live |= touched;
+        } else {
+            alive[i] = 0;
+            removed++;
+        }
+    }
+    stats->outside_light_cone += removed;
+    return removed;
+}
+
+/* Backward pass removing diagonal gates whose qubits are all measured next */
+static int prune_diagonal(const QuantumCircuit *circuit, unsigned char *alive, LightConeStats *stats) {
+    unsigned int measured_next = 0;
+    int removed = 0;
+
+    for (int i = circuit->num_gates - 1; i >= 0; i--) {
+        if (!alive[i]) continue;
+        const QuantumGate *gate = &circuit->gates[i];
+        unsigned int touched = quantum_circuit_gate_qubits(gate, circuit->num_qubits);
+
+        if (is_measurement(gate->type)) {
+            measured_next |= touched;
+        } else if (is_diagonal(gate->type) && (touched & ~measured_next) == 0) {
+            alive[i] = 0;
+            removed++;
+        } else {
+            measured_next &= ~touched;
+        }
+    }
+    stats->diagonal_before_measurement += removed;
+    return removed;
+}
+
+/* Qubits touched by the gates, plus the observed ones read from the final state */
+static unsigned int active_qubits(const QuantumCircuit *circuit, unsigned int observed) {
+    unsigned int active = 0;
+
+    for (int i = 0; i < circuit->num_gates; i++) {
+        const QuantumGate *gate = &circuit->gates[i];
+        /* Collapsing unobserved qubits that no gate touches changes nothing */
+        active |= gate->type == GATE_MEASURE_ALL ? observed
+                                                 : quantum_circuit_gate_qubits(gate, circuit->num_qubits);
+    }
+    return active | (observed & ~measured_qubits(circuit, NULL));
+}
+
+int quantum_optimise_light_cone(QuantumCircuit *circuit, unsigned int observed, LightConeStats *stats) {
+    LightConeStats local;
+    unsigned char alive[MAX_GATES];
+
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(LightConeStats));
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return 0;
+    }
+
+    if (observed == 0) observed = all_qubits(circuit->num_qubits);
+    observed &= all_qubits(circuit->num_qubits);
+    stats->gates_before = circuit->num_gates;
+    memset(alive, 1, (size_t)circuit->num_gates);
+
+    /* Each pass can disconnect qubits the other relied on */
+    while (prune_light_cone(circuit, alive, observed, stats) + prune_diagonal(circuit, alive, stats) > 0) {
+    }
+
+    int kept = 0;
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (alive[i]) circuit->gates[kept++] = circuit->gates[i];
+    }
+    circuit->num_gates = kept;
+    stats->gates_after = kept;
+    stats->active_qubits = active_qubits(circuit, observed);
+
+    return stats->gates_before - kept;
+}
+
+QuantumCircuit* quantum_optimise_restrict(const QuantumCircuit *circuit, unsigned int observed,
+                                          QubitRestriction *restriction) {
+    if (!circuit || !restriction) {
+        fprintf(stderr, "Error: Null circuit or restriction\n");
+        return NULL;
+    }
+
+    if (observed == 0) observed = all_qubits(circuit->num_qubits);
+    unsigned int active = active_qubits(circuit, observed & all_qubits(circuit->num_qubits));
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (circuit->gates[i].type == GATE_ORACLE) active = all_qubits(circuit->num_qubits);
+    }
+    if (active == 0) active = 1;  /* Circuits need at least one qubit */
+
+    int map[MAX_MAPPED_QUBITS];
+    restriction->num_qubits = 0;
+    for (int q = 0; q < circuit->num_qubits; q++) {
+        map[q] = -1;
+        if (active & (1u << q)) {
+            map[q] = restriction->num_qubits;
+            restriction->qubits[restriction->num_qubits++] = q;
+        }
+    }
+
+    QuantumCircuit *restricted = malloc(sizeof(QuantumCircuit));
+    if (!restricted) {
+        fprintf(stderr, "Error: Failed to allocate memory for restricted circuit\n");
+        return NULL;
+    }
+
+    /* Order is preserved, so QFT ranges stay contiguous */
+    *restricted = *circuit;
+    restricted->num_qubits = restriction->num_qubits;
+    for (int i = 0; i < restricted->num_gates; i++) {
+        QuantumGate *gate = &restricted->gates[i];
+        if (gate->type == GATE_MEASURE_ALL || gate->type == GATE_ORACLE) continue;
+        gate->qubit1 = map[gate->qubit1];
+        if (gate->qubit2 >= 0) gate->qubit2 = map[gate->qubit2];
+    }
+    return restricted;
+}
+
+int quantum_optimise_expand_index(const QubitRestriction *restriction, int index) {
+    int expanded = 0;
+    for (int i = 0; i < restriction->num_qubits; i++) {
+        if (index & (1 << i)) expanded |= 1 << restriction->qubits[i];
+    }
+    return expanded;
+}
+
+QuantumState* quantum_optimise_run_light_cone(const QuantumCircuit *circuit, unsigned int observed,
+                                              QubitRestriction *restriction, LightConeStats *stats) {
+    if (!circuit || !restriction) {
+        fprintf(stderr, "Error: Null circuit or restriction\n");
+        return NULL;
+    }
+
+    QuantumCircuit *pruned = malloc(sizeof(QuantumCircuit));
+    if (!pruned) {
+        fprintf(stderr, "Error: Failed to allocate memory for pruned circuit\n");
+        return NULL;
+    }
+    *pruned = *circuit;
+    quantum_optimise_light_cone(pruned, observed, stats);
+
+    QuantumCircuit *restricted = quantum_optimise_restrict(pruned, observed, restriction);
+    free(pruned);
+    if (!restricted) return NULL;
+
+    QuantumState *state = restricted->num_qubits <= MAX_QUBITS
+                          ? quantum_state_create(restricted->num_qubits)
+                          : quantum_state_create_mapped(restricted->num_qubits, NULL);
+    if (state) {
+        quantum_state_enable_product_form(state);
+        quantum_state_initialise_zero(state);
+        for (int i = 0; i < restricted->num_gates; i++) {
+            if (!quantum_circuit_apply_gate(&restricted->gates[i], state, NULL)) {
+                quantum_state_destroy(state);
+                state = NULL;
+                break;
+            }
+        }
+    }
+
+    free(restricted);
+    return state;
+}
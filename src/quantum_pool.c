@@ -0,0 +1,107 @@
+#include "quantum_pool.h"
+#include "quantum_numa.h"
+#include "quantum_state.h"
+#include <pthread.h>
+
+/* Class k holds buffers of 2^k amplitudes */
+#define POOL_NUM_CLASSES (MAX_QUBITS + 1)
+
+typedef struct {
+    Complex *buffers[POOL_CLASS_DEPTH];
+    int count;
+} PoolClass;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static PoolClass pool_classes[POOL_NUM_CLASSES];
+static size_t pool_limit = POOL_DEFAULT_LIMIT_BYTES;
+static PoolStats pool_stats;
+
+/* Size class of a power-of-two count, or -1 for counts the pool does not keep */
+static int size_class(size_t count) {
+    if (count == 0 || (count & (count - 1)) != 0) return -1;
+    int k = 0;
+    while (((size_t)1 << k) < count) k++;
+    return k < POOL_NUM_CLASSES ? k : -1;
+}
+
+Complex* quantum_pool_acquire(size_t count) {
+    int k = size_class(count);
+    Complex *amplitudes = NULL;
+
+    pthread_mutex_lock(&pool_lock);
+    if (k >= 0 && pool_classes[k].count > 0) {
+        amplitudes = pool_classes[k].buffers[--pool_classes[k].count];
+        pool_stats.cached_bytes -= count * sizeof(Complex);
+        pool_stats.hits++;
+    } else {
+        pool_stats.misses++;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    if (!amplitudes) amplitudes = quantum_numa_alloc_amplitudes(count);
+    return amplitudes;
+}
+
+void quantum_pool_release(Complex *amplitudes, size_t count) {
+    if (!amplitudes) return;
+    int k = size_class(count);
+    size_t bytes = count * sizeof(Complex);
+    int kept = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    if (k >= 0 && pool_classes[k].count < POOL_CLASS_DEPTH && pool_stats.cached_bytes + bytes <= pool_limit) {
+        pool_classes[k].buffers[pool_classes[k].count++] = amplitudes;
+        pool_stats.cached_bytes += bytes;
+        kept = 1;
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    if (!kept) quantum_numa_free_amplitudes(amplitudes, count);
+}
+
+/* Frees cached buffers, largest classes first, until the limit holds */
+static void shrink_to_limit(void) {
+    Complex *released[POOL_NUM_CLASSES * POOL_CLASS_DEPTH];
+    size_t counts[POOL_NUM_CLASSES * POOL_CLASS_DEPTH];
+    int num_released = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    for (int k = POOL_NUM_CLASSES - 1; k >= 0 && pool_stats.cached_bytes > pool_limit; k--) {
+        size_t count = (size_t)1 << k;
+        while (pool_classes[k].count > 0 && pool_stats.cached_bytes > pool_limit) {
+            released[num_released] = pool_classes[k].buffers[--pool_classes[k].count];
+            counts[num_released++] = count;
+            pool_stats.cached_bytes -= count * sizeof(Complex);
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    /* Unmapping is slow, so it happens outside the lock */
+    for (int i = 0; i < num_released; i++) {
+        quantum_numa_free_amplitudes(released[i], counts[i]);
+    }
+}
+
+void quantum_pool_set_limit(size_t bytes) {
+    pthread_mutex_lock(&pool_lock);
+    pool_limit = bytes;
+    pthread_mutex_unlock(&pool_lock);
+    shrink_to_limit();
+}
+
+void quantum_pool_trim(void) {
+    pthread_mutex_lock(&pool_lock);
+    size_t limit = pool_limit;
+    pool_limit = 0;
+    pthread_mutex_unlock(&pool_lock);
+
+    shrink_to_limit();
+    quantum_pool_set_limit(limit);
+}
+
+void quantum_pool_get_stats(PoolStats *stats) {
+    if (!stats) return;
+    pthread_mutex_lock(&pool_lock);
+    *stats = pool_stats;
+    pthread_mutex_unlock(&pool_lock);
+}
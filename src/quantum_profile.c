@@ -0,0 +1,173 @@
+#include "quantum_profile.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Read on every gate by whichever thread applies it, so it is only accessed
+ * atomically; a thread that sees the profile also sees it reset */
+static ExecutionProfile *active_profile = NULL;
+
+void quantum_profile_start(ExecutionProfile *profile) {
+    if (profile) quantum_profile_reset(profile);
+    __atomic_store_n(&active_profile, profile, __ATOMIC_RELEASE);
+}
+
+void quantum_profile_stop(void) {
+    __atomic_store_n(&active_profile, NULL, __ATOMIC_RELEASE);
+}
+
+ExecutionProfile* quantum_profile_active(void) {
+    return __atomic_load_n(&active_profile, __ATOMIC_ACQUIRE);
+}
+
+double quantum_profile_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+void quantum_profile_reset(ExecutionProfile *profile) {
+    if (profile) memset(profile, 0, sizeof(ExecutionProfile));
+}
+
+/* Full-state passes for each gate, matching how the kernels walk the amplitudes:
+ * diagonal and controlled gates only visit the amplitudes they change */
+static double gate_passes(const QuantumGate *gate) {
+    switch (gate->type) {
+        case GATE_PAULI_X:
+        case GATE_PAULI_Y:
+        case GATE_HADAMARD:
+        case GATE_ROTATION_X:
+        case GATE_ROTATION_Y:
+        case GATE_ROTATION_Z:
+        case GATE_MEASURE_ALL:
+        case GATE_ORACLE:
+            return 1.0;
+        case GATE_PAULI_Z:
+        case GATE_PHASE:
+        case GATE_CNOT:
+        case GATE_SWAP:
+            return 0.5;
+        case GATE_CZ:
+        case GATE_CONTROLLED_PHASE:
+            return 0.25;
+        case GATE_MEASURE:
+            return 2.0;  /* Probability pass, then collapse and renormalise */
+        case GATE_QFT:
+        case GATE_IQFT:
+            return gate->qubit2 - gate->qubit1 + 2.0;  /* Bit reversal plus one pass per butterfly stage */
+        default:
+            return 0.0;
+    }
+}
+
+double quantum_profile_gate_bytes(const QuantumGate *gate, int num_qubits) {
+    double state_bytes = (double)((size_t)1 << num_qubits) * sizeof(Complex);
+    return gate_passes(gate) * state_bytes * 2.0;
+}
+
+double quantum_profile_bandwidth(const ProfileCounter *counter) {
+    return counter->seconds > 0.0 ? counter->bytes / counter->seconds / 1e9 : 0.0;
+}
+
+static void add_sample(ProfileCounter *counter, double seconds, double bytes) {
+    counter->calls++;
+    counter->seconds += seconds;
+    counter->bytes += bytes;
+}
+
+void quantum_profile_record(ExecutionProfile *profile, const QuantumGate *gate, int num_qubits, double seconds) {
+    if (!profile || !gate || (unsigned int)gate->type >= NUM_GATE_TYPES) return;
+
+    double bytes = quantum_profile_gate_bytes(gate, num_qubits);
+    int target = -1;
+    switch (gate->type) {
+        case GATE_MEASURE_ALL:
+        case GATE_QFT:
+        case GATE_IQFT:
+        case GATE_ORACLE:
+            break;
+        case GATE_CNOT:
+        case GATE_CZ:
+        case GATE_SWAP:
+        case GATE_CONTROLLED_PHASE:
+            target = gate->qubit2;
+            break;
+        default:
+            target = gate->qubit1;
+            break;
+    }
+
+    /* Batch workers may execute circuits concurrently */
+    #pragma omp critical(quantum_profile)
+    {
+        add_sample(&profile->gate_types[gate->type], seconds, bytes);
+        if (target >= 0 && target < MAX_MAPPED_QUBITS) {
+            add_sample(&profile->target_qubits[target], seconds, bytes);
+        }
+        add_sample(&profile->total, seconds, bytes);
+    }
+}
+
+void quantum_profile_record_fused(ExecutionProfile *profile, int qubit, int num_qubits, double seconds) {
+    if (!profile) return;
+
+    double bytes = (double)((size_t)1 << num_qubits) * sizeof(Complex) * 2.0;
+
+    #pragma omp critical(quantum_profile)
+    {
+        add_sample(&profile->fused, seconds, bytes);
+        if (qubit >= 0 && qubit < MAX_MAPPED_QUBITS) {
+            add_sample(&profile->target_qubits[qubit], seconds, bytes);
+        }
+        add_sample(&profile->total, seconds, bytes);
+    }
+}
+
+static void print_row(const char *label, const ProfileCounter *counter, double total_seconds) {
+    printf("  %-8s %10lld %12.6f %6.1f%% %12.3f %10.2f\n", label, counter->calls, counter->seconds,
+           total_seconds > 0.0 ? 100.0 * counter->seconds / total_seconds : 0.0,
+           counter->calls ? 1e6 * counter->seconds / counter->calls : 0.0, quantum_profile_bandwidth(counter));
+}
+
+/* Indices of the non-empty counters, ordered by descending time */
+static int sort_counters(const ProfileCounter *counters, int count, int *order) {
+    int used = 0;
+    for (int i = 0; i < count; i++) {
+        if (counters[i].calls == 0) continue;
+        int j = used++;
+        while (j > 0 && counters[order[j - 1]].seconds < counters[i].seconds) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    return used;
+}
+
+void quantum_profile_print(const ExecutionProfile *profile) {
+    if (!profile) return;
+
+    int order[NUM_GATE_TYPES > MAX_MAPPED_QUBITS ? NUM_GATE_TYPES : MAX_MAPPED_QUBITS];
+    double total = profile->total.seconds;
+    char label[16];
+
+    printf("\nExecution profile: %lld gates, %.6f s, %.2f GB/s\n",
+           profile->total.calls, total, quantum_profile_bandwidth(&profile->total));
+
+    printf("  %-8s %10s %12s %7s %12s %10s\n", "Gate", "Calls", "Seconds", "Share", "us/call", "GB/s");
+    int used = sort_counters(profile->gate_types, NUM_GATE_TYPES, order);
+    for (int i = 0; i < used; i++) {
+        print_row(gate_type_to_string((GateType)order[i]), &profile->gate_types[order[i]], total);
+    }
+    if (profile->fused.calls > 0) print_row("Fused", &profile->fused, total);
+
+    used = sort_counters(profile->target_qubits, MAX_MAPPED_QUBITS, order);
+    if (used > 0) {
+        printf("  %-8s %10s %12s %7s %12s %10s\n", "Target", "Calls", "Seconds", "Share", "us/call", "GB/s");
+        for (int i = 0; i < used; i++) {
+            snprintf(label, sizeof(label), "q%d", order[i]);
+            print_row(label, &profile->target_qubits[order[i]], total);
+        }
+    }
+}
@@ -0,0 +1,323 @@
+#include "quantum_program.h"
+#include "quantum_gates.h"
+#include "quantum_profile.h"
+#include "complex_kernels.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+void quantum_program_gate_matrix(const QuantumGate *gate, Complex matrix[4]) {
+    double theta = gate->parameter;
+    double c = cos(theta / 2.0);
+    double s = sin(theta / 2.0);
+    double h = 1.0 / sqrt(2.0);
+    
+    switch (gate->type) {
+        case GATE_PAULI_X:
+            matrix[0] = complex_create(0.0, 0.0); matrix[1] = complex_create(1.0, 0.0);
+            matrix[2] = complex_create(1.0, 0.0); matrix[3] = complex_create(0.0, 0.0);
+            break;
+        case GATE_PAULI_Y:
+            matrix[0] = complex_create(0.0, 0.0); matrix[1] = complex_create(0.0, -1.0);
+            matrix[2] = complex_create(0.0, 1.0); matrix[3] = complex_create(0.0, 0.0);
+            break;
+        case GATE_PAULI_Z:
+            matrix[0] = complex_create(1.0, 0.0); matrix[1] = complex_create(0.0, 0.0);
+            matrix[2] = complex_create(0.0, 0.0); matrix[3] = complex_create(-1.0, 0.0);
+            break;
+        case GATE_HADAMARD:
+            matrix[0] = complex_create(h, 0.0); matrix[1] = complex_create(h, 0.0);
+            matrix[2] = complex_create(h, 0.0); matrix[3] = complex_create(-h, 0.0);
+            break;
+        case GATE_PHASE:
+            matrix[0] = complex_create(1.0, 0.0); matrix[1] = complex_create(0.0, 0.0);
+            matrix[2] = complex_create(0.0, 0.0); matrix[3] = complex_from_polar(1.0, theta);
+            break;
+        case GATE_ROTATION_X:
+            matrix[0] = complex_create(c, 0.0); matrix[1] = complex_create(0.0, -s);
+            matrix[2] = complex_create(0.0, -s); matrix[3] = complex_create(c, 0.0);
+            break;
+        case GATE_ROTATION_Y:
+            matrix[0] = complex_create(c, 0.0); matrix[1] = complex_create(-s, 0.0);
+            matrix[2] = complex_create(s, 0.0); matrix[3] = complex_create(c, 0.0);
+            break;
+        case GATE_ROTATION_Z:
+            matrix[0] = complex_from_polar(1.0, -theta / 2.0); matrix[1] = complex_create(0.0, 0.0);
+            matrix[2] = complex_create(0.0, 0.0); matrix[3] = complex_from_polar(1.0, theta / 2.0);
+            break;
+        default:
+            matrix[0] = complex_create(1.0, 0.0); matrix[1] = complex_create(0.0, 0.0);
+            matrix[2] = complex_create(0.0, 0.0); matrix[3] = complex_create(1.0, 0.0);
+            break;
+    }
+}
+
+/* result = a * b for row-major 2x2 matrices */
+static void matrix_multiply(const Complex a[4], const Complex b[4], Complex result[4]) {
+    Complex r[4];
+    r[0] = complex_kernel_add(complex_kernel_multiply(a[0], b[0]), complex_kernel_multiply(a[1], b[2]));
+    r[1] = complex_kernel_add(complex_kernel_multiply(a[0], b[1]), complex_kernel_multiply(a[1], b[3]));
+    r[2] = complex_kernel_add(complex_kernel_multiply(a[2], b[0]), complex_kernel_multiply(a[3], b[2]));
+    r[3] = complex_kernel_add(complex_kernel_multiply(a[2], b[1]), complex_kernel_multiply(a[3], b[3]));
+    memcpy(result, r, sizeof(r));
+}
+
+static void rebuild_op_matrix(QuantumProgram *program, ProgramOp *op) {
+    Complex gate_matrix[4];
+    
+    quantum_program_gate_matrix(&program->gates[op->first_gate], op->matrix);
+    for (int g = program->gate_next[op->first_gate]; g >= 0; g = program->gate_next[g]) {
+        quantum_program_gate_matrix(&program->gates[g], gate_matrix);
+        matrix_multiply(gate_matrix, op->matrix, op->matrix);
+    }
+}
+
+static int validate_gate(const QuantumCircuit *circuit, const QuantumGate *gate, int index) {
+    int n = circuit->num_qubits;
+    
+    if (gate->qubit1 < 0 || gate->qubit1 >= n || gate->qubit2 < -1 || gate->qubit2 >= n) {
+        fprintf(stderr, "Error: Gate %d acts on a qubit out of range [0, %d)\n", index, n);
+        return 0;
+    }
+    if (gate->parameter_index >= circuit->num_parameters) {
+        fprintf(stderr, "Error: Gate %d uses undefined parameter %d\n", index, gate->parameter_index);
+        return 0;
+    }
+    
+    switch (gate->type) {
+        case GATE_CNOT:
+        case GATE_CZ:
+        case GATE_SWAP:
+        case GATE_CONTROLLED_PHASE:
+            if (gate->qubit2 < 0 || gate->qubit1 == gate->qubit2) {
+                fprintf(stderr, "Error: Gate %d needs two distinct qubits\n", index);
+                return 0;
+            }
+            break;
+        case GATE_QFT:
+        case GATE_IQFT:
+            if (gate->qubit2 < gate->qubit1) {
+                fprintf(stderr, "Error: Gate %d has an invalid QFT range\n", index);
+                return 0;
+            }
+            break;
+        case GATE_ORACLE:
+            if (!validate_oracle(n, gate->oracle)) return 0;
+            break;
+        default:
+            break;
+    }
+    return 1;
+}
+
+QuantumProgram* quantum_program_compile(const QuantumCircuit *circuit) {
+    if (!circuit) {
+        fprintf(stderr, "Error: Null circuit\n");
+        return NULL;
+    }
+    
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (!validate_gate(circuit, &circuit->gates[i], i)) return NULL;
+    }
+    
+    QuantumProgram *program = calloc(1, sizeof(QuantumProgram));
+    if (!program) {
+        fprintf(stderr, "Error: Failed to allocate memory for program\n");
+        return NULL;
+    }
+    
+    int num_gates = circuit->num_gates;
+    int num_parameters = circuit->num_parameters;
+    program->num_qubits = circuit->num_qubits;
+    program->num_parameters = num_parameters;
+    program->num_gates = num_gates;
+    program->gates = malloc((num_gates + 1) * sizeof(QuantumGate));
+    program->gate_next = malloc((num_gates + 1) * sizeof(int));
+    program->gate_op = malloc((num_gates + 1) * sizeof(int));
+    program->ops = malloc((num_gates + 1) * sizeof(ProgramOp));
+    program->op_dirty = calloc(num_gates + 1, 1);
+    program->parameter_op_start = calloc(num_parameters + 1, sizeof(int));
+    program->parameter_ops = malloc((num_gates + 1) * sizeof(int));
+    program->bound_values = calloc(num_parameters + 1, sizeof(double));
+    
+    if (!program->gates || !program->gate_next || !program->gate_op || !program->ops ||
+        !program->op_dirty || !program->parameter_op_start || !program->parameter_ops ||
+        !program->bound_values) {
+        fprintf(stderr, "Error: Failed to allocate memory for program\n");
+        quantum_program_destroy(program);
+        return NULL;
+    }
+    
+    memcpy(program->gates, circuit->gates, num_gates * sizeof(QuantumGate));
+    
+    /* Fusion plan: a single-qubit gate joins the open matrix op on its qubit;
+     * any other gate closes the open ops on the qubits it touches. Gates
+     * only move earlier past gates on disjoint qubits, so order is kept. */
+    int open_op[32];
+    int last_gate[32];
+    for (int q = 0; q < 32; q++) open_op[q] = -1;
+    
+    program->num_ops = 0;
+    for (int i = 0; i < num_gates; i++) {
+        const QuantumGate *gate = &program->gates[i];
+        program->gate_next[i] = -1;
+        
+        if (quantum_circuit_is_single_qubit_unitary(gate->type)) {
+            int q = gate->qubit1;
+            if (open_op[q] >= 0) {
+                ProgramOp *op = &program->ops[open_op[q]];
+                program->gate_next[last_gate[q]] = i;
+                op->num_gates++;
+                op->parameterised |= (gate->parameter_index >= 0);
+            } else {
+                ProgramOp *op = &program->ops[program->num_ops];
+                op->type = PROGRAM_OP_MATRIX;
+                op->qubit = q;
+                op->first_gate = i;
+                op->num_gates = 1;
+                op->parameterised = (gate->parameter_index >= 0);
+                open_op[q] = program->num_ops++;
+            }
+            last_gate[q] = i;
+            program->gate_op[i] = open_op[q];
+        } else {
+            unsigned int touched = quantum_circuit_gate_qubits(gate, program->num_qubits);
+            for (int q = 0; q < program->num_qubits; q++) {
+                if (touched & (1u << q)) open_op[q] = -1;
+            }
+            
+            ProgramOp *op = &program->ops[program->num_ops];
+            op->type = PROGRAM_OP_GATE;
+            op->qubit = gate->qubit1;
+            op->first_gate = i;
+            op->num_gates = 1;
+            op->parameterised = 0;
+            program->gate_op[i] = program->num_ops++;
+        }
+    }
+    
+    /* Parameter -> dependent ops, in CSR form (an op may appear twice) */
+    for (int i = 0; i < num_gates; i++) {
+        int p = program->gates[i].parameter_index;
+        if (p >= 0) program->parameter_op_start[p + 1]++;
+    }
+    for (int p = 0; p < num_parameters; p++) {
+        program->parameter_op_start[p + 1] += program->parameter_op_start[p];
+    }
+    int *fill = calloc(num_parameters + 1, sizeof(int));
+    if (!fill) {
+        fprintf(stderr, "Error: Failed to allocate memory for program\n");
+        quantum_program_destroy(program);
+        return NULL;
+    }
+    for (int i = 0; i < num_gates; i++) {
+        int p = program->gates[i].parameter_index;
+        if (p >= 0) {
+            program->parameter_ops[program->parameter_op_start[p] + fill[p]++] = program->gate_op[i];
+        }
+    }
+    free(fill);
+    
+    /* Fixed matrices are built once here */
+    for (int k = 0; k < program->num_ops; k++) {
+        ProgramOp *op = &program->ops[k];
+        if (op->type == PROGRAM_OP_MATRIX && !op->parameterised) {
+            rebuild_op_matrix(program, op);
+        }
+    }
+    
+    program->is_bound = (num_parameters == 0);
+    return program;
+}
+
+void quantum_program_destroy(QuantumProgram *program) {
+    if (program) {
+        free(program->gates);
+        free(program->gate_next);
+        free(program->gate_op);
+        free(program->ops);
+        free(program->op_dirty);
+        free(program->parameter_op_start);
+        free(program->parameter_ops);
+        free(program->bound_values);
+        free(program);
+    }
+}
+
+int quantum_program_bind(QuantumProgram *program, const double *values) {
+    if (!program) {
+        fprintf(stderr, "Error: Null program\n");
+        return 0;
+    }
+    if (program->num_parameters == 0) return 1;
+    if (!values) {
+        fprintf(stderr, "Error: Null parameter values\n");
+        return 0;
+    }
+    
+    /* Mark ops whose parameters changed */
+    for (int p = 0; p < program->num_parameters; p++) {
+        if (program->is_bound && values[p] == program->bound_values[p]) continue;
+        
+        program->bound_values[p] = values[p];
+        for (int k = program->parameter_op_start[p]; k < program->parameter_op_start[p + 1]; k++) {
+            program->op_dirty[program->parameter_ops[k]] = 1;
+        }
+    }
+    
+    for (int k = 0; k < program->num_ops; k++) {
+        if (!program->op_dirty[k]) continue;
+        
+        ProgramOp *op = &program->ops[k];
+        for (int g = op->first_gate; g >= 0; g = program->gate_next[g]) {
+            QuantumGate *gate = &program->gates[g];
+            if (gate->parameter_index >= 0) {
+                gate->parameter = program->bound_values[gate->parameter_index];
+            }
+        }
+        rebuild_op_matrix(program, op);
+        program->op_dirty[k] = 0;
+    }
+    
+    program->is_bound = 1;
+    return 1;
+}
+
+int quantum_program_execute(const QuantumProgram *program, QuantumState *state) {
+    if (!program || !state) {
+        fprintf(stderr, "Error: Null program or state\n");
+        return 0;
+    }
+    if (program->num_qubits != state->num_qubits) {
+        fprintf(stderr, "Error: Program and state have different numbers of qubits\n");
+        return 0;
+    }
+    if (!program->is_bound) {
+        fprintf(stderr, "Error: Program parameters have not been bound\n");
+        return 0;
+    }
+    
+    for (int k = 0; k < program->num_ops; k++) {
+        const ProgramOp *op = &program->ops[k];
+        
+        /* Lone gates keep their specialised kernels */
+        if (op->type == PROGRAM_OP_MATRIX && op->num_gates > 1) {
+            ExecutionProfile *profile = quantum_profile_active();
+            double start = profile ? quantum_profile_seconds() : 0.0;
+            gate_unitary(state, op->qubit, op->matrix);
+            if (profile) {
+                quantum_profile_record_fused(profile, op->qubit, state->num_qubits, quantum_profile_seconds() - start);
+            }
+        } else if (!quantum_circuit_apply_gate(&program->gates[op->first_gate], state, NULL)) {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+int quantum_program_run(QuantumProgram *program, const double *values, QuantumState *state) {
+    if (!quantum_program_bind(program, values)) return 0;
+    return quantum_program_execute(program, state);
+}
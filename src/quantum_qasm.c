@@ -0,0 +1,834 @@
+#include "quantum_qasm.h"
+#include "quantum_program.h"
+#include "quantum_optimise.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/* Define M_PI if not available */
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/* Most gates one QASM gate can expand to (cswap) plus headroom */
+#define QASM_MAX_EXPANSION 20
+#define QASM_MAX_OPERANDS 3
+#define QASM_MAX_PARAMS 3
+
+typedef struct {
+    char name[32];
+    size_t name_length;
+    int offset;
+    int size;
+} QasmRegister;
+
+typedef struct {
+    QasmRegister registers[QASM_MAX_REGISTERS];
+    int num_registers;
+    int num_qubits;
+    QuantumCircuit *chunk;
+    QasmChunkHandler handler;
+    void *context;
+    QasmStats *stats;
+    long line;
+    const char *text;   /* Newlines before text[counted] are counted in line */
+    size_t counted;
+    size_t position;    /* End of the statement being parsed */
+    int last_register;  /* Operands mostly repeat the previous register */
+} QasmParser;
+
+typedef enum {
+    QASM_ID, QASM_X, QASM_Y, QASM_Z, QASM_H, QASM_S, QASM_SDG, QASM_T, QASM_TDG,
+    QASM_SX, QASM_SXDG, QASM_RX, QASM_RY, QASM_RZ, QASM_P, QASM_U2, QASM_U3,
+    QASM_CX, QASM_CY, QASM_CZ, QASM_SWAP, QASM_CP, QASM_CRZ, QASM_CCX, QASM_CSWAP
+} QasmGateKind;
+
+/* Slot of a gate name in qasm_gates, from its first, second, last characters
+ * and length (second is 0 for one-letter names). No two names share a slot;
+ * a collision shows up as an overridden initialiser warning. */
+#define QASM_NAME_HASH(first, second, last, length) \
+    (((first) * 15 + (second) * 38 + (last) * 8 + (length) * 7) & 63)
+
+typedef struct {
+    const char *name;
+    QasmGateKind kind;
+    int num_params;
+    int num_qubits;
+} QasmGate;
+
+static const QasmGate qasm_gates[64] = {
+    [QASM_NAME_HASH('c', 'x', 'x', 2)] = {"cx", QASM_CX, 0, 2},
+    [QASM_NAME_HASH('h', 0, 'h', 1)] = {"h", QASM_H, 0, 1},
+    [QASM_NAME_HASH('r', 'z', 'z', 2)] = {"rz", QASM_RZ, 1, 1},
+    [QASM_NAME_HASH('x', 0, 'x', 1)] = {"x", QASM_X, 0, 1},
+    [QASM_NAME_HASH('y', 0, 'y', 1)] = {"y", QASM_Y, 0, 1},
+    [QASM_NAME_HASH('z', 0, 'z', 1)] = {"z", QASM_Z, 0, 1},
+    [QASM_NAME_HASH('r', 'x', 'x', 2)] = {"rx", QASM_RX, 1, 1},
+    [QASM_NAME_HASH('r', 'y', 'y', 2)] = {"ry", QASM_RY, 1, 1},
+    [QASM_NAME_HASH('t', 0, 't', 1)] = {"t", QASM_T, 0, 1},
+    [QASM_NAME_HASH('t', 'd', 'g', 3)] = {"tdg", QASM_TDG, 0, 1},
+    [QASM_NAME_HASH('s', 0, 's', 1)] = {"s", QASM_S, 0, 1},
+    [QASM_NAME_HASH('s', 'd', 'g', 3)] = {"sdg", QASM_SDG, 0, 1},
+    [QASM_NAME_HASH('u', '3', '3', 2)] = {"u3", QASM_U3, 3, 1},
+    [QASM_NAME_HASH('u', 0, 'u', 1)] = {"u", QASM_U3, 3, 1},
+    [QASM_NAME_HASH('U', 0, 'U', 1)] = {"U", QASM_U3, 3, 1},
+    [QASM_NAME_HASH('u', '2', '2', 2)] = {"u2", QASM_U2, 2, 1},
+    [QASM_NAME_HASH('u', '1', '1', 2)] = {"u1", QASM_P, 1, 1},
+    [QASM_NAME_HASH('p', 0, 'p', 1)] = {"p", QASM_P, 1, 1},
+    [QASM_NAME_HASH('C', 'X', 'X', 2)] = {"CX", QASM_CX, 0, 2},
+    [QASM_NAME_HASH('c', 'z', 'z', 2)] = {"cz", QASM_CZ, 0, 2},
+    [QASM_NAME_HASH('c', 'y', 'y', 2)] = {"cy", QASM_CY, 0, 2},
+    [QASM_NAME_HASH('s', 'w', 'p', 4)] = {"swap", QASM_SWAP, 0, 2},
+    [QASM_NAME_HASH('c', 'p', 'p', 2)] = {"cp", QASM_CP, 1, 2},
+    [QASM_NAME_HASH('c', 'u', '1', 3)] = {"cu1", QASM_CP, 1, 2},
+    [QASM_NAME_HASH('c', 'r', 'z', 3)] = {"crz", QASM_CRZ, 1, 2},
+    [QASM_NAME_HASH('c', 'c', 'x', 3)] = {"ccx", QASM_CCX, 0, 3},
+    [QASM_NAME_HASH('c', 's', 'p', 5)] = {"cswap", QASM_CSWAP, 0, 3},
+    [QASM_NAME_HASH('s', 'x', 'x', 2)] = {"sx", QASM_SX, 0, 1},
+    [QASM_NAME_HASH('s', 'x', 'g', 4)] = {"sxdg", QASM_SXDG, 0, 1},
+    [QASM_NAME_HASH('i', 'd', 'd', 2)] = {"id", QASM_ID, 0, 1},
+};
+
+/* Lines are only needed for errors, so newlines are counted in bulk and late,
+ * eight bytes at a time: a byte of x is zero exactly where the text has '\n' */
+static void count_lines(QasmParser *parser) {
+    const uint64_t ones = 0x0101010101010101ULL, low7 = 0x7F7F7F7F7F7F7F7FULL;
+    size_t i = parser->counted;
+
+    for (; i + 8 <= parser->position; i += 8) {
+        uint64_t word;
+        memcpy(&word, parser->text + i, sizeof(word));
+        uint64_t x = word ^ (ones * '\n');
+        uint64_t zero = ~(((x & low7) + low7) | x | low7);  /* 0x80 in each zero byte */
+        parser->line += (long)(((zero >> 7) * ones) >> 56);
+    }
+    for (; i < parser->position; i++) {
+        parser->line += parser->text[i] == '\n';
+    }
+    if (parser->position > parser->counted) parser->counted = parser->position;
+}
+
+static int qasm_error(QasmParser *parser, const char *message) {
+    count_lines(parser);
+    fprintf(stderr, "Error: QASM line %ld: %s\n", parser->line, message);
+    return 0;
+}
+
+/* The character classes are inlined; the ctype calls dominated the scan */
+static inline int is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static inline int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline int is_identifier_start(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static const char* skip_space(const char *p, const char *end) {
+    while (p < end && is_space(*p)) p++;
+    return p;
+}
+
+/* End of the identifier at p, or p itself if there is none */
+static const char* scan_identifier(const char *p, const char *end) {
+    if (p < end && is_identifier_start(*p)) {
+        while (p < end && (is_identifier_start(*p) || is_digit(*p))) p++;
+    }
+    return p;
+}
+
+static const char* parse_identifier(const char *p, const char *end, char *out, size_t size) {
+    const char *after = scan_identifier(p, end);
+    size_t length = (size_t)(after - p) < size ? (size_t)(after - p) : size - 1;
+    memcpy(out, p, length);
+    out[length] = '\0';
+    return after;
+}
+
+/* Non-negative decimal integer; NULL if there are no digits */
+static const char* parse_index(const char *p, const char *end, long *value) {
+    const char *digits = p;
+    *value = 0;
+    while (p < end && is_digit(*p)) {
+        if (*value < (long)1 << 40) *value = *value * 10 + (*p - '0');
+        p++;
+    }
+    return p == digits ? NULL : p;
+}
+
+/* Names here are a few characters, shorter than a library call's overhead */
+static inline int name_equals(const char *name, const char *word, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (name[i] != word[i]) return 0;
+    }
+    return name[length] == '\0';
+}
+
+static const QasmGate* find_gate(const char *word, size_t length) {
+    if (length == 0 || length > 5) return NULL;
+    unsigned char second = length > 1 ? (unsigned char)word[1] : 0;
+    const QasmGate *gate = &qasm_gates[QASM_NAME_HASH((unsigned char)word[0], second,
+                                                      (unsigned char)word[length - 1], length)];
+    if (!gate->name || !name_equals(gate->name, word, length)) return NULL;
+    return gate;
+}
+
+// =============================================================================
+// PARAMETER EXPRESSIONS
+// =============================================================================
+
+static double parse_sum(const char **p, const char *end, int *ok);
+
+/* Unsigned decimal literal; NULL if there is none */
+static const char* parse_number(const char *p, const char *end, double *value) {
+    /* Up to 15 digits and a power of ten are both exact doubles, so one
+     * division rounds correctly; anything longer goes to strtod */
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8,
+                                    1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+    const char *t = p;
+    long long mantissa = 0;
+    int digits = 0, fraction = 0;
+    while (t < end && is_digit(*t)) {
+        if (++digits <= 15) mantissa = mantissa * 10 + (*t - '0');
+        t++;
+    }
+    if (t < end && *t == '.') {
+        t++;
+        while (t < end && is_digit(*t)) {
+            if (++digits <= 15) mantissa = mantissa * 10 + (*t - '0');
+            fraction++;
+            t++;
+        }
+    }
+    if (digits > 0 && digits <= 15 && (t >= end || (*t != 'e' && *t != 'E'))) {
+        *value = (double)mantissa / powers[fraction];
+        return t;
+    }
+
+    char *number_end;
+    *value = strtod(p, &number_end);
+    if (number_end == p || number_end > end) return NULL;
+    return number_end;
+}
+
+static double parse_primary(const char **p, const char *end, int *ok) {
+    const char *s = skip_space(*p, end);
+
+    if (s < end && *s == '(') {
+        s++;
+        double value = parse_sum(&s, end, ok);
+        s = skip_space(s, end);
+        if (s >= end || *s != ')') *ok = 0;
+        *p = s + 1;
+        return value;
+    }
+
+    if (s < end && (is_digit(*s) || *s == '.')) {
+        double value;
+        const char *after = parse_number(s, end, &value);
+        if (!after) *ok = 0;
+        *p = after ? after : end;
+        return value;
+    }
+
+    char name[8];
+    const char *after = parse_identifier(s, end, name, sizeof(name));
+    if (strcmp(name, "pi") == 0) {
+        *p = after;
+        return M_PI;
+    }
+
+    /* Unary functions from the QASM 2 grammar */
+    static const struct { const char *name; double (*function)(double); } functions[] = {
+        {"sin", sin}, {"cos", cos}, {"tan", tan}, {"exp", exp}, {"ln", log}, {"sqrt", sqrt}
+    };
+    for (size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        if (strcmp(name, functions[i].name) == 0) {
+            *p = after;
+            return functions[i].function(parse_primary(p, end, ok));
+        }
+    }
+
+    *ok = 0;
+    *p = after;
+    return 0.0;
+}
+
+static double parse_unary(const char **p, const char *end, int *ok) {
+    const char *s = skip_space(*p, end);
+    if (s < end && (*s == '-' || *s == '+')) {
+        *p = s + 1;
+        double value = parse_unary(p, end, ok);
+        return (*s == '-') ? -value : value;
+    }
+    *p = s;
+
+    double value = parse_primary(p, end, ok);
+    const char *t = skip_space(*p, end);
+    if (t < end && *t == '^') {
+        *p = t + 1;
+        value = pow(value, parse_unary(p, end, ok));
+    }
+    return value;
+}
+
+static double parse_product(const char **p, const char *end, int *ok) {
+    double value = parse_unary(p, end, ok);
+
+    for (;;) {
+        const char *s = skip_space(*p, end);
+        if (s >= end || (*s != '*' && *s != '/')) break;
+        *p = s + 1;
+        double rhs = parse_unary(p, end, ok);
+        value = (*s == '*') ? value * rhs : value / rhs;
+    }
+    return value;
+}
+
+static double parse_sum(const char **p, const char *end, int *ok) {
+    double value = parse_product(p, end, ok);
+
+    for (;;) {
+        const char *s = skip_space(*p, end);
+        if (s >= end || (*s != '+' && *s != '-')) break;
+        *p = s + 1;
+        double rhs = parse_product(p, end, ok);
+        value = (*s == '+') ? value + rhs : value - rhs;
+    }
+    return value;
+}
+
+// =============================================================================
+// OPERANDS AND CHUNKS
+// =============================================================================
+
+/* Names longer than the register buffer are compared on their stored prefix */
+static int register_matches(const QasmRegister *reg, const char *name, size_t length) {
+    if (length >= sizeof(reg->name)) length = sizeof(reg->name) - 1;
+    return reg->name_length == length && name_equals(reg->name, name, length);
+}
+
+/* Register reference: index -1 selects the whole register */
+static const char* parse_operand(QasmParser *parser, const char *p, const char *end,
+                                 int *reg, int *index) {
+    const char *name = skip_space(p, end);
+    p = scan_identifier(name, end);
+    size_t length = (size_t)(p - name);
+
+    *reg = parser->last_register;
+    if (*reg >= parser->num_registers || !register_matches(&parser->registers[*reg], name, length)) {
+        *reg = -1;
+        for (int r = 0; r < parser->num_registers; r++) {
+            if (register_matches(&parser->registers[r], name, length)) {
+                *reg = r;
+                break;
+            }
+        }
+        if (*reg < 0) return NULL;
+        parser->last_register = *reg;
+    }
+
+    *index = -1;
+    p = skip_space(p, end);
+    if (p < end && *p == '[') {
+        long value;
+        p = parse_index(skip_space(p + 1, end), end, &value);
+        if (!p) return NULL;
+        p = skip_space(p, end);
+        if (p >= end || *p != ']' || value >= parser->registers[*reg].size) return NULL;
+        *index = (int)value;
+        p++;
+    }
+    return p;
+}
+
+static int ensure_chunk(QasmParser *parser) {
+    if (parser->chunk) return 1;
+    if (parser->num_qubits == 0) return qasm_error(parser, "gate before any qreg declaration");
+
+    parser->chunk = quantum_circuit_create(parser->num_qubits, "QASM chunk");
+    if (!parser->chunk) return 0;
+    if (parser->stats) parser->stats->num_qubits = parser->num_qubits;
+    return 1;
+}
+
+static int flush_chunk(QasmParser *parser) {
+    if (!parser->handler(parser->chunk, parser->context)) return 0;
+    if (parser->stats) parser->stats->chunks++;
+    quantum_circuit_clear(parser->chunk);
+    return 1;
+}
+
+/* qelib1 decomposition of ccx into H, T and CNOT */
+static int add_toffoli(QuantumCircuit *c, int a, int b, int t) {
+    if (a == b || a == t || b == t) return 0;
+
+    return quantum_circuit_add_hadamard(c, t) &&
+           quantum_circuit_add_cnot(c, b, t) &&
+           quantum_circuit_add_phase(c, t, -M_PI / 4.0) &&
+           quantum_circuit_add_cnot(c, a, t) &&
+           quantum_circuit_add_phase(c, t, M_PI / 4.0) &&
+           quantum_circuit_add_cnot(c, b, t) &&
+           quantum_circuit_add_phase(c, t, -M_PI / 4.0) &&
+           quantum_circuit_add_cnot(c, a, t) &&
+           quantum_circuit_add_phase(c, b, M_PI / 4.0) &&
+           quantum_circuit_add_phase(c, t, M_PI / 4.0) &&
+           quantum_circuit_add_hadamard(c, t) &&
+           quantum_circuit_add_cnot(c, a, b) &&
+           quantum_circuit_add_phase(c, a, M_PI / 4.0) &&
+           quantum_circuit_add_phase(c, b, -M_PI / 4.0) &&
+           quantum_circuit_add_cnot(c, a, b);
+}
+
+static int emit_gate(QasmParser *parser, QasmGateKind kind, const double *params, const int *q) {
+    QuantumCircuit *c = parser->chunk;
+
+    if (c->num_gates + QASM_MAX_EXPANSION > MAX_GATES && !flush_chunk(parser)) return 0;
+    int ok = 1;
+
+    switch (kind) {
+        case QASM_ID: break;
+        case QASM_X: ok = quantum_circuit_add_pauli_x(c, q[0]); break;
+        case QASM_Y: ok = quantum_circuit_add_pauli_y(c, q[0]); break;
+        case QASM_Z: ok = quantum_circuit_add_pauli_z(c, q[0]); break;
+        case QASM_H: ok = quantum_circuit_add_hadamard(c, q[0]); break;
+        case QASM_S: ok = quantum_circuit_add_phase(c, q[0], M_PI / 2.0); break;
+        case QASM_SDG: ok = quantum_circuit_add_phase(c, q[0], -M_PI / 2.0); break;
+        case QASM_T: ok = quantum_circuit_add_phase(c, q[0], M_PI / 4.0); break;
+        case QASM_TDG: ok = quantum_circuit_add_phase(c, q[0], -M_PI / 4.0); break;
+        /* sx = RX(π/2) up to global phase */
+        case QASM_SX: ok = quantum_circuit_add_rotation_x(c, q[0], M_PI / 2.0); break;
+        case QASM_SXDG: ok = quantum_circuit_add_rotation_x(c, q[0], -M_PI / 2.0); break;
+        case QASM_RX: ok = quantum_circuit_add_rotation_x(c, q[0], params[0]); break;
+        case QASM_RY: ok = quantum_circuit_add_rotation_y(c, q[0], params[0]); break;
+        case QASM_RZ: ok = quantum_circuit_add_rotation_z(c, q[0], params[0]); break;
+        case QASM_P: ok = quantum_circuit_add_phase(c, q[0], params[0]); break;
+        /* U(θ,φ,λ) = P(φ)·RY(θ)·P(λ) exactly */
+        case QASM_U2:
+            ok = quantum_circuit_add_phase(c, q[0], params[1]) &&
+                 quantum_circuit_add_rotation_y(c, q[0], M_PI / 2.0) &&
+                 quantum_circuit_add_phase(c, q[0], params[0]);
+            break;
+        case QASM_U3:
+            ok = quantum_circuit_add_phase(c, q[0], params[2]) &&
+                 quantum_circuit_add_rotation_y(c, q[0], params[0]) &&
+                 quantum_circuit_add_phase(c, q[0], params[1]);
+            break;
+        case QASM_CX: ok = quantum_circuit_add_cnot(c, q[0], q[1]); break;
+        case QASM_CZ: ok = quantum_circuit_add_cz(c, q[0], q[1]); break;
+        case QASM_SWAP: ok = quantum_circuit_add_swap(c, q[0], q[1]); break;
+        case QASM_CP: ok = quantum_circuit_add_controlled_phase(c, q[0], q[1], params[0]); break;
+        case QASM_CY:
+            ok = quantum_circuit_add_phase(c, q[1], -M_PI / 2.0) &&
+                 quantum_circuit_add_cnot(c, q[0], q[1]) &&
+                 quantum_circuit_add_phase(c, q[1], M_PI / 2.0);
+            break;
+        case QASM_CRZ:
+            ok = quantum_circuit_add_rotation_z(c, q[1], params[0] / 2.0) &&
+                 quantum_circuit_add_cnot(c, q[0], q[1]) &&
+                 quantum_circuit_add_rotation_z(c, q[1], -params[0] / 2.0) &&
+                 quantum_circuit_add_cnot(c, q[0], q[1]);
+            break;
+        case QASM_CCX:
+            ok = add_toffoli(c, q[0], q[1], q[2]);
+            break;
+        case QASM_CSWAP:
+            ok = quantum_circuit_add_cnot(c, q[2], q[1]) &&
+                 add_toffoli(c, q[0], q[1], q[2]) &&
+                 quantum_circuit_add_cnot(c, q[2], q[1]);
+            break;
+    }
+
+    if (!ok) return qasm_error(parser, "invalid gate operands");
+    if (parser->stats) parser->stats->gates++;
+    return 1;
+}
+
+// =============================================================================
+// STATEMENTS
+// =============================================================================
+
+static int parse_qreg(QasmParser *parser, const char *p, const char *end) {
+    if (parser->chunk) return qasm_error(parser, "qreg after the first gate is not supported");
+    if (parser->num_registers >= QASM_MAX_REGISTERS) return qasm_error(parser, "too many registers");
+
+    QasmRegister *reg = &parser->registers[parser->num_registers];
+    const char *name = skip_space(p, end);
+    p = scan_identifier(name, end);
+    reg->name_length = (size_t)(p - name);
+    if (reg->name_length >= sizeof(reg->name)) reg->name_length = sizeof(reg->name) - 1;
+    memcpy(reg->name, name, reg->name_length);
+    reg->name[reg->name_length] = '\0';
+    p = skip_space(p, end);
+    if (reg->name_length == 0 || p >= end || *p != '[') return qasm_error(parser, "malformed qreg");
+
+    char *number_end;
+    long size = strtol(p + 1, &number_end, 10);
+    p = skip_space(number_end, end);
+    if (p >= end || *p != ']' || size < 1 || parser->num_qubits + size > MAX_MAPPED_QUBITS) {
+        return qasm_error(parser, "invalid qreg size");
+    }
+
+    reg->offset = parser->num_qubits;
+    reg->size = (int)size;
+    parser->num_qubits += reg->size;
+    parser->num_registers++;
+    return 1;
+}
+
+static int parse_measure(QasmParser *parser, const char *p, const char *end) {
+    int reg, index;
+    if (!parse_operand(parser, p, end, &reg, &index)) return qasm_error(parser, "malformed measure");
+    if (!ensure_chunk(parser)) return 0;
+
+    const QasmRegister *r = &parser->registers[reg];
+    if (parser->chunk->num_gates + r->size > MAX_GATES && !flush_chunk(parser)) return 0;
+
+    if (index >= 0) {
+        quantum_circuit_add_measure(parser->chunk, r->offset + index);
+    } else if (r->size == parser->num_qubits) {
+        quantum_circuit_add_measure_all(parser->chunk);
+    } else {
+        for (int k = 0; k < r->size; k++) {
+            quantum_circuit_add_measure(parser->chunk, r->offset + k);
+        }
+    }
+    if (parser->stats) {
+        parser->stats->gates += (index >= 0) ? 1 : r->size;
+        parser->stats->measurements++;
+    }
+    return 1;
+}
+
+static int parse_statement(QasmParser *parser, const char *p, const char *end) {
+    p = skip_space(p, end);
+    if (p >= end) return 1;
+    if (parser->stats) parser->stats->statements++;
+
+    const char *word_start = p;
+    p = scan_identifier(p, end);
+
+    /* Gates are the common case, so they are looked up before the keywords */
+    const QasmGate *gate = find_gate(word_start, (size_t)(p - word_start));
+    if (!gate) {
+        char word[32];
+        parse_identifier(word_start, end, word, sizeof(word));
+        if (strcmp(word, "OPENQASM") == 0 || strcmp(word, "include") == 0 ||
+            strcmp(word, "creg") == 0 || strcmp(word, "barrier") == 0) {
+            return 1;
+        }
+        if (strcmp(word, "qreg") == 0) return parse_qreg(parser, p, end);
+        if (strcmp(word, "measure") == 0) return parse_measure(parser, p, end);
+        return qasm_error(parser, "unsupported statement");
+    }
+
+    /* Parameters */
+    double params[QASM_MAX_PARAMS] = {0.0};
+    int num_params = 0;
+    p = skip_space(p, end);
+    if (p < end && *p == '(') {
+        p++;
+        for (;;) {
+            int ok = 1;
+            if (num_params >= QASM_MAX_PARAMS) return qasm_error(parser, "too many parameters");
+
+            /* Most parameters are plain literals; anything else is an expression */
+            const char *literal = skip_space(p, end);
+            int negative = literal < end && *literal == '-';
+            const char *after = parse_number(literal + negative, end, &params[num_params]);
+            if (after) after = skip_space(after, end);
+            if (after && after < end && (*after == ',' || *after == ')')) {
+                if (negative) params[num_params] = -params[num_params];
+                num_params++;
+                p = after;
+            } else {
+                params[num_params++] = parse_sum(&p, end, &ok);
+                if (!ok) return qasm_error(parser, "malformed parameter expression");
+                p = skip_space(p, end);
+            }
+            if (p < end && *p == ',') { p++; continue; }
+            if (p < end && *p == ')') { p++; break; }
+            return qasm_error(parser, "malformed parameter list");
+        }
+    }
+    if (num_params != gate->num_params) return qasm_error(parser, "wrong number of parameters");
+
+    /* Operands, with whole registers broadcast element-wise */
+    int regs[QASM_MAX_OPERANDS], indices[QASM_MAX_OPERANDS];
+    int num_operands = 0;
+    int width = 1;
+    for (;;) {
+        if (num_operands >= QASM_MAX_OPERANDS) return qasm_error(parser, "too many operands");
+        p = parse_operand(parser, p, end, &regs[num_operands], &indices[num_operands]);
+        if (!p) return qasm_error(parser, "unknown register or index out of range");
+
+        if (indices[num_operands] < 0) {
+            int size = parser->registers[regs[num_operands]].size;
+            if (width != 1 && size != width) return qasm_error(parser, "register sizes differ");
+            width = size;
+        }
+        num_operands++;
+
+        p = skip_space(p, end);
+        if (p < end && *p == ',') { p++; continue; }
+        break;
+    }
+    if (skip_space(p, end) != end) return qasm_error(parser, "unexpected characters after operands");
+    if (num_operands != gate->num_qubits) return qasm_error(parser, "wrong number of operands");
+    if (!ensure_chunk(parser)) return 0;
+
+    for (int k = 0; k < width; k++) {
+        int qubits[QASM_MAX_OPERANDS];
+        for (int j = 0; j < num_operands; j++) {
+            qubits[j] = parser->registers[regs[j]].offset + (indices[j] >= 0 ? indices[j] : k);
+        }
+        if (!emit_gate(parser, gate->kind, params, qubits)) return 0;
+    }
+    return 1;
+}
+
+// =============================================================================
+// STREAMING
+// =============================================================================
+
+int quantum_qasm_stream(FILE *file, QasmChunkHandler handler, void *context, QasmStats *stats) {
+    if (!file || !handler) {
+        fprintf(stderr, "Error: Null QASM file or handler\n");
+        return 0;
+    }
+
+    QasmParser parser;
+    memset(&parser, 0, sizeof(parser));
+    parser.handler = handler;
+    parser.context = context;
+    parser.stats = stats;
+    parser.line = 1;
+    if (stats) memset(stats, 0, sizeof(QasmStats));
+
+    size_t capacity = QASM_READ_BLOCK;
+    char *buffer = malloc(capacity + 1);
+    if (!buffer) {
+        fprintf(stderr, "Error: Failed to allocate memory for QASM buffer\n");
+        return 0;
+    }
+
+    /* Statements are parsed in place between `start` and each ';'.
+     * Comments are blanked as they are scanned, so a ';' inside one is inert. */
+    size_t length = 0, pos = 0, start = 0;
+    int in_comment = 0, at_eof = 0, success = 1;
+
+    while (success) {
+        /* Keep one byte of lookahead for "//" */
+        if (pos + 1 >= length && !at_eof) {
+            if (start > 0) {
+                parser.text = buffer;
+                parser.position = start;
+                count_lines(&parser);
+                parser.counted = 0;
+                memmove(buffer, buffer + start, length - start);
+                length -= start;
+                pos -= start;
+                start = 0;
+            }
+            if (length == capacity) {
+                char *grown = realloc(buffer, capacity * 2 + 1);
+                if (!grown) {
+                    fprintf(stderr, "Error: Failed to allocate memory for QASM buffer\n");
+                    success = 0;
+                    break;
+                }
+                buffer = grown;
+                capacity *= 2;
+            }
+            size_t n = fread(buffer + length, 1, capacity - length, file);
+            if (n == 0) at_eof = 1;
+            length += n;
+            buffer[length] = ';';
+            if (stats) stats->bytes += n;
+            continue;
+        }
+        if (pos >= length) break;
+
+        /* Comments are blanked up to their newline, which stays for the line count */
+        if (in_comment) {
+            char *newline = memchr(buffer + pos, '\n', length - pos);
+            size_t stop = newline ? (size_t)(newline - buffer) : length;
+            memset(buffer + pos, ' ', stop - pos);
+            pos = stop;
+            if (newline) in_comment = 0;
+            continue;
+        }
+
+        /* The next ';' (the buffer ends in a sentinel one), unless a '/' comes first */
+        size_t stop = (size_t)((char *)memchr(buffer + pos, ';', length + 1 - pos) - buffer);
+        char *slash = memchr(buffer + pos, '/', stop - pos);
+        if (slash) {
+            pos = (size_t)(slash - buffer);
+            if (pos + 1 >= length && !at_eof) continue;
+            if (pos + 1 < length && buffer[pos + 1] == '/') {
+                in_comment = 1;
+                continue;
+            }
+            pos++;
+            continue;
+        }
+
+        pos = stop;
+        if (pos >= length) continue;
+        parser.text = buffer;
+        parser.position = pos;
+        success = parse_statement(&parser, buffer + start, buffer + pos);
+        start = ++pos;
+    }
+
+    parser.text = buffer;
+    parser.position = length;
+    if (success && skip_space(buffer + start, buffer + length) != buffer + length) {
+        success = qasm_error(&parser, "missing ';' at end of file");
+    }
+
+    /* Final partial chunk; a file with no gates still reports its size */
+    if (success && parser.num_qubits > 0) {
+        success = ensure_chunk(&parser) && flush_chunk(&parser);
+    }
+
+    quantum_circuit_destroy(parser.chunk);
+    free(buffer);
+    return success;
+}
+
+// =============================================================================
+// FILE ENTRY POINTS
+// =============================================================================
+
+static int append_chunk(QuantumCircuit *chunk, void *context) {
+    QuantumCircuit **circuit = context;
+
+    if (!*circuit) {
+        *circuit = quantum_circuit_create(chunk->num_qubits, "QASM Circuit");
+        if (!*circuit) return 0;
+    }
+    if ((*circuit)->num_gates + chunk->num_gates > MAX_GATES) {
+        fprintf(stderr, "Error: QASM circuit exceeds %d gates; use streaming execution\n", MAX_GATES);
+        return 0;
+    }
+
+    memcpy(&(*circuit)->gates[(*circuit)->num_gates], chunk->gates, chunk->num_gates * sizeof(QuantumGate));
+    (*circuit)->num_gates += chunk->num_gates;
+    return 1;
+}
+
+QuantumCircuit* quantum_qasm_parse_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open QASM file %s\n", path);
+        return NULL;
+    }
+
+    QuantumCircuit *circuit = NULL;
+    if (!quantum_qasm_stream(file, append_chunk, &circuit, NULL)) {
+        quantum_circuit_destroy(circuit);
+        circuit = NULL;
+    }
+
+    fclose(file);
+    return circuit;
+}
+
+typedef struct {
+    CircuitFileWriter *writer;
+    const char *path;
+} QasmCompile;
+
+static int write_chunk(QuantumCircuit *chunk, void *context) {
+    QasmCompile *compile = context;
+
+    if (!compile->writer) {
+        compile->writer = quantum_circuit_writer_open(compile->path, chunk->num_qubits, "QASM Circuit");
+        if (!compile->writer) return 0;
+    }
+    return quantum_circuit_writer_append(compile->writer, chunk);
+}
+
+int quantum_qasm_compile_file(const char *path, const char *binary_path, QasmStats *stats) {
+    if (!binary_path) {
+        fprintf(stderr, "Error: Null circuit file path\n");
+        return 0;
+    }
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open QASM file %s\n", path);
+        return 0;
+    }
+
+    QasmCompile compile = {NULL, binary_path};
+    int success = quantum_qasm_stream(file, write_chunk, &compile, stats);
+    fclose(file);
+
+    if (compile.writer && !quantum_circuit_writer_close(compile.writer)) return 0;
+    /* The writer would otherwise leave a valid file holding only the gates before the error */
+    if (!success && compile.writer) remove(binary_path);
+    return success;
+}
+
+typedef struct {
+    QuantumState *state;
+    QasmStats *stats;
+    QasmStateAllocator allocate;
+    void *allocate_context;
+} QasmRun;
+
+static int execute_chunk(QuantumCircuit *chunk, void *context) {
+    QasmRun *run = context;
+
+    if (!run->state) {
+        run->state = run->allocate ? run->allocate(chunk->num_qubits, run->allocate_context)
+                                   : quantum_state_create(chunk->num_qubits);
+        if (!run->state) return 0;
+        /* Preparation layers stay factored until the first entangling gate */
+        quantum_state_enable_product_form(run->state);
+        quantum_state_initialise_zero(run->state);
+    }
+
+    /* Peephole-optimise, then compile to fuse the remaining single-qubit runs */
+    int removed = quantum_optimise_circuit(chunk, NULL);
+    if (run->stats) run->stats->gates_removed += removed;
+
+    QuantumProgram *program = quantum_program_compile(chunk);
+    if (!program) return 0;
+
+    int success = quantum_program_execute(program, run->state);
+    quantum_program_destroy(program);
+    return success;
+}
+
+QuantumState* quantum_qasm_run_stream(FILE *file, QasmStateAllocator allocate, void *context, QasmStats *stats) {
+    QasmRun run;
+    run.state = NULL;
+    run.stats = stats;
+    run.allocate = allocate;
+    run.allocate_context = context;
+
+    if (!quantum_qasm_stream(file, execute_chunk, &run, stats)) {
+        /* A caller-supplied state goes back to the caller's allocator */
+        if (!allocate) quantum_state_destroy(run.state);
+        run.state = NULL;
+    }
+    return run.state;
+}
+
+QuantumState* quantum_qasm_run_file(const char *path, QasmStats *stats) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Error: Cannot open QASM file %s\n", path);
+        return NULL;
+    }
+
+    QuantumState *state = quantum_qasm_run_stream(file, NULL, NULL, stats);
+    fclose(file);
+    return state;
+}
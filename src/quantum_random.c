@@ -0,0 +1,64 @@
+#include "quantum_random.h"
+#include <stdlib.h>
+#include <time.h>
+
+static __thread QuantumRandom *thread_stream = NULL;
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotate_left(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void quantum_random_seed(QuantumRandom *random, uint64_t seed, uint64_t stream) {
+    if (!random) return;
+
+    /* Mixing the stream number in before expansion keeps nearby streams unrelated */
+    uint64_t x = seed ^ splitmix64(&stream);
+    for (int k = 0; k < 4; k++) {
+        random->s[k] = splitmix64(&x);
+    }
+}
+
+uint64_t quantum_random_next(QuantumRandom *random) {
+    uint64_t *s = random->s;
+    uint64_t result = rotate_left(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotate_left(s[3], 45);
+    return result;
+}
+
+double quantum_random_double(QuantumRandom *random) {
+    /* Top 53 bits fill the double's mantissa exactly */
+    return (double)(quantum_random_next(random) >> 11) * 0x1.0p-53;
+}
+
+void quantum_random_set_thread_stream(QuantumRandom *random) {
+    thread_stream = random;
+}
+
+QuantumRandom* quantum_random_thread_stream(void) {
+    return thread_stream;
+}
+
+double quantum_random_uniform(void) {
+    if (thread_stream) return quantum_random_double(thread_stream);
+
+    static int seed_initialised = 0;
+    if (!seed_initialised) {
+        srand((unsigned int)time(NULL));
+        seed_initialised = 1;
+    }
+    return (double)rand() / RAND_MAX;
+}
@@ -0,0 +1,756 @@
+#include "quantum_service.h"
+#include "quantum_circuit.h"
+#include "quantum_qasm.h"
+#include "quantum_profile.h"
+#include "quantum_random.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define SERVICE_MAX_WORKERS 64
+#define SERVICE_MAX_CONNECTIONS 256
+#define SERVICE_ERROR_LENGTH 256
+
+// =============================================================================
+// SOCKET I/O
+// =============================================================================
+
+/* Returns 1 when all bytes moved, 0 on error or a peer that went away */
+static int read_full(int fd, void *buffer, size_t length) {
+    char *p = buffer;
+    while (length > 0) {
+        ssize_t n = read(fd, p, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+static int write_full(int fd, const void *buffer, size_t length) {
+    const char *p = buffer;
+    while (length > 0) {
+        ssize_t n = send(fd, p, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        length -= (size_t)n;
+    }
+    return 1;
+}
+
+static int make_address(const char *path, struct sockaddr_un *address) {
+    if (!path || strlen(path) >= sizeof(address->sun_path)) {
+        fprintf(stderr, "Error: Socket path must be shorter than %zu bytes\n", sizeof(address->sun_path));
+        return 0;
+    }
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, path);
+    return 1;
+}
+
+// =============================================================================
+// STATE POOL
+// =============================================================================
+
+/* Free states by qubit count; at most one per worker is ever needed per size */
+typedef struct {
+    pthread_mutex_t lock;
+    QuantumState *states[MAX_QUBITS + 1][SERVICE_MAX_WORKERS];
+    int num_free[MAX_QUBITS + 1];
+} StatePool;
+
+static QuantumState* pool_acquire(StatePool *pool, int num_qubits) {
+    QuantumState *state = NULL;
+
+    if (num_qubits < 1 || num_qubits > MAX_QUBITS) return NULL;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->num_free[num_qubits] > 0) {
+        state = pool->states[num_qubits][--pool->num_free[num_qubits]];
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (!state) {
+        state = quantum_state_create(num_qubits);
+        if (!state) return NULL;
+        quantum_state_enable_product_form(state);
+    }
+    quantum_state_initialise_zero(state);
+    return state;
+}
+
+static void pool_release(StatePool *pool, QuantumState *state) {
+    if (!state) return;
+
+    pthread_mutex_lock(&pool->lock);
+    int n = state->num_qubits;
+    if (pool->num_free[n] < SERVICE_MAX_WORKERS) {
+        pool->states[n][pool->num_free[n]++] = state;
+        state = NULL;
+    }
+    pthread_mutex_unlock(&pool->lock);
+    quantum_state_destroy(state);
+}
+
+static void pool_destroy(StatePool *pool) {
+    for (int n = 0; n <= MAX_QUBITS; n++) {
+        for (int k = 0; k < pool->num_free[n]; k++) {
+            quantum_state_destroy(pool->states[n][k]);
+        }
+        pool->num_free[n] = 0;
+    }
+}
+
+// =============================================================================
+// SERVICE AND WORKERS
+// =============================================================================
+
+/*
+ * The main thread polls the listening socket and idle connections. A
+ * connection with a request waiting is queued for a worker, which reads the
+ * request, runs it and replies with blocking I/O, then hands the connection
+ * back through wake_pipe so it is polled again.
+ */
+typedef struct {
+    int listen_fd;
+    int wake_pipe[2];
+    volatile int stopping;
+
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    int queue[SERVICE_MAX_CONNECTIONS];
+    int queue_head;
+    int queue_length;
+
+    int num_connections;  /* Accepted and not yet closed, under lock */
+
+    StatePool pool;
+    int threads_per_job;
+} Service;
+
+typedef struct {
+    Service *service;
+    QuantumRandom random;  /* Stream for sampling and the circuits' measurements */
+
+    /* Per-job inputs and scratch, grown as needed and kept across jobs */
+    char *circuit;
+    size_t circuit_capacity;
+    PauliTerm *terms;
+    size_t terms_capacity;
+    double *parameters;
+    size_t parameters_capacity;
+    double *values;  /* Cumulative probabilities or expectation values */
+    size_t values_capacity;
+    uint32_t *hits;
+    size_t hits_capacity;
+    ServiceCount *counts;
+    size_t counts_capacity;
+
+    QuantumState *state;  /* Pooled state of the job being run */
+    char error[SERVICE_ERROR_LENGTH];
+} ServiceWorker;
+
+static volatile sig_atomic_t stop_signalled = 0;
+
+static void handle_stop_signal(int signal_number) {
+    (void)signal_number;
+    stop_signalled = 1;
+}
+
+static void* reserve(void **buffer, size_t *capacity, size_t bytes) {
+    if (bytes > *capacity) {
+        void *grown = realloc(*buffer, bytes);
+        if (!grown) return NULL;
+        *buffer = grown;
+        *capacity = bytes;
+    }
+    return *buffer;
+}
+
+static int job_error(ServiceWorker *worker, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(worker->error, sizeof(worker->error), format, args);
+    va_end(args);
+    return 0;
+}
+
+static void queue_push(Service *service, int fd) {
+    pthread_mutex_lock(&service->lock);
+    int tail = (service->queue_head + service->queue_length) % SERVICE_MAX_CONNECTIONS;
+    service->queue[tail] = fd;
+    service->queue_length++;
+    pthread_cond_signal(&service->ready);
+    pthread_mutex_unlock(&service->lock);
+}
+
+/* Next connection to serve, or -1 once the service is stopping */
+static int queue_pop(Service *service) {
+    int fd = -1;
+
+    pthread_mutex_lock(&service->lock);
+    while (service->queue_length == 0 && !service->stopping) {
+        pthread_cond_wait(&service->ready, &service->lock);
+    }
+    if (service->queue_length > 0) {
+        fd = service->queue[service->queue_head];
+        service->queue_head = (service->queue_head + 1) % SERVICE_MAX_CONNECTIONS;
+        service->queue_length--;
+    }
+    pthread_mutex_unlock(&service->lock);
+    return fd;
+}
+
+static void stop_service(Service *service) {
+    pthread_mutex_lock(&service->lock);
+    service->stopping = 1;
+    pthread_cond_broadcast(&service->ready);
+    pthread_mutex_unlock(&service->lock);
+}
+
+static void close_connection(Service *service, int fd) {
+    close(fd);
+    pthread_mutex_lock(&service->lock);
+    service->num_connections--;
+    pthread_mutex_unlock(&service->lock);
+}
+
+/* Hands a connection back to the poll loop; -1 only wakes it */
+static void wake_poll_loop(Service *service, int fd) {
+    while (write(service->wake_pipe[1], &fd, sizeof(fd)) < 0 && errno == EINTR) {
+    }
+}
+
+// =============================================================================
+// JOB EXECUTION
+// =============================================================================
+
+static QuantumState* acquire_job_state(int num_qubits, void *context) {
+    ServiceWorker *worker = context;
+
+    if (num_qubits > MAX_QUBITS) {
+        job_error(worker, "circuit has %d qubits; the service runs at most %d", num_qubits, MAX_QUBITS);
+        return NULL;
+    }
+    worker->state = pool_acquire(&worker->service->pool, num_qubits);
+    if (!worker->state) job_error(worker, "cannot allocate a %d-qubit state", num_qubits);
+    return worker->state;
+}
+
+static void release_job_state(ServiceWorker *worker) {
+    pool_release(&worker->service->pool, worker->state);
+    worker->state = NULL;
+}
+
+/* Runs the request's circuit into worker->state; *measured is set when the
+ * circuit measures, which makes each shot a separate run */
+static int run_circuit(ServiceWorker *worker, const ServiceRequest *request, int *measured) {
+    *measured = 0;
+
+    if (request->format == SERVICE_FORMAT_QASM) {
+        QasmStats stats;
+        FILE *stream = fmemopen(worker->circuit, (size_t)request->circuit_bytes, "rb");
+        if (!stream) return job_error(worker, "cannot open the QASM text");
+
+        QuantumState *state = quantum_qasm_run_stream(stream, acquire_job_state, worker, &stats);
+        fclose(stream);
+        if (!state) {
+            if (worker->error[0] == '\0') job_error(worker, "QASM parse or execution failed; see the service log");
+            return 0;
+        }
+        *measured = stats.measurements > 0;
+        return 1;
+    }
+
+    MappedCircuit view;
+    if (!quantum_circuit_view_binary(worker->circuit, (size_t)request->circuit_bytes, &view)) {
+        return job_error(worker, "invalid binary circuit; see the service log");
+    }
+    if (view.header->num_parameters != request->num_parameters) {
+        return job_error(worker, "circuit has %u parameters but %u values were sent",
+                         view.header->num_parameters, request->num_parameters);
+    }
+    if (!acquire_job_state((int)view.header->num_qubits, worker)) return 0;
+
+    for (uint64_t i = 0; i < view.header->num_gates && !*measured; i++) {
+        *measured = view.records[i].type == GATE_MEASURE || view.records[i].type == GATE_MEASURE_ALL;
+    }
+    if (!quantum_circuit_execute_mapped(&view, worker->state, worker->parameters)) {
+        return job_error(worker, "binary circuit execution failed; see the service log");
+    }
+    return 1;
+}
+
+static int count_outcomes(ServiceWorker *worker, const ServiceRequest *request, uint32_t *num_records) {
+    int measured;
+    if (!run_circuit(worker, request, &measured)) return 0;
+
+    int num_states = worker->state->num_states;
+    uint32_t *hits = reserve((void **)&worker->hits, &worker->hits_capacity, (size_t)num_states * sizeof(uint32_t));
+    ServiceCount *counts = reserve((void **)&worker->counts, &worker->counts_capacity,
+                                   (size_t)num_states * sizeof(ServiceCount));
+    double *cumulative = measured ? NULL : reserve((void **)&worker->values, &worker->values_capacity,
+                                                   (size_t)num_states * sizeof(double));
+    if (!hits || !counts || (!measured && !cumulative)) return job_error(worker, "out of memory for counts");
+    memset(hits, 0, (size_t)num_states * sizeof(uint32_t));
+
+    if (measured) {
+        /* Each shot re-runs the circuit, since its measurements collapse the state */
+        for (uint32_t shot = 0; shot < request->shots; shot++) {
+            if (shot > 0) {
+                release_job_state(worker);
+                if (!run_circuit(worker, request, &measured)) return 0;
+            }
+            hits[quantum_state_measure_all(worker->state)]++;
+        }
+    } else {
+        /* One run, then every shot is a binary search of the distribution */
+        double total = quantum_state_cumulative(worker->state, cumulative);
+        if (total < 0.0) return job_error(worker, "out of memory for counts");
+        for (uint32_t shot = 0; shot < request->shots; shot++) {
+            hits[quantum_state_draw(cumulative, num_states, total, &worker->random)]++;
+        }
+    }
+
+    uint32_t records = 0;
+    for (int i = 0; i < num_states; i++) {
+        if (hits[i] > 0) {
+            ServiceCount count = {(uint32_t)i, hits[i]};
+            counts[records++] = count;
+        }
+    }
+    *num_records = records;
+    return 1;
+}
+
+static int read_request_body(ServiceWorker *worker, int fd, const ServiceRequest *request) {
+    size_t term_bytes = (size_t)request->num_terms * sizeof(PauliTerm);
+    size_t parameter_bytes = (size_t)request->num_parameters * sizeof(double);
+
+    /* One spare byte keeps QASM text terminated for the error paths */
+    if (!reserve((void **)&worker->circuit, &worker->circuit_capacity, (size_t)request->circuit_bytes + 1) ||
+        !reserve((void **)&worker->terms, &worker->terms_capacity, term_bytes + 1) ||
+        !reserve((void **)&worker->parameters, &worker->parameters_capacity, parameter_bytes + 1)) {
+        return 0;
+    }
+    worker->circuit[request->circuit_bytes] = '\0';
+    return read_full(fd, worker->circuit, (size_t)request->circuit_bytes) &&
+           read_full(fd, worker->terms, term_bytes) &&
+           read_full(fd, worker->parameters, parameter_bytes);
+}
+
+static int validate_request(ServiceWorker *worker, const ServiceRequest *request) {
+    if (memcmp(request->magic, SERVICE_REQUEST_MAGIC, sizeof(request->magic)) != 0) {
+        return job_error(worker, "not a service request");
+    }
+    if (request->format > SERVICE_FORMAT_BINARY || request->result > SERVICE_RESULT_SHUTDOWN) {
+        return job_error(worker, "unknown circuit format or result kind");
+    }
+    if (request->circuit_bytes > SERVICE_MAX_CIRCUIT_BYTES || request->num_terms > SERVICE_MAX_TERMS ||
+        request->num_parameters > MAX_PARAMETERS || request->shots > SERVICE_MAX_SHOTS) {
+        return job_error(worker, "request exceeds the service limits");
+    }
+    return 1;
+}
+
+static int reply(int fd, ServiceStatus status, int num_qubits, uint32_t num_records,
+                 const void *payload, size_t payload_bytes, double seconds) {
+    ServiceResponse response;
+    memcpy(response.magic, SERVICE_RESPONSE_MAGIC, sizeof(response.magic));
+    response.status = status;
+    response.num_qubits = (uint32_t)num_qubits;
+    response.num_records = num_records;
+    response.payload_bytes = payload_bytes;
+    response.seconds = seconds;
+    return write_full(fd, &response, sizeof(response)) && write_full(fd, payload, payload_bytes);
+}
+
+/* Serves one request; returns 0 when the connection should be closed */
+static int serve_request(ServiceWorker *worker, int fd) {
+    ServiceRequest request;
+    if (!read_full(fd, &request, sizeof(request))) return 0;
+
+    worker->error[0] = '\0';
+    if (!validate_request(worker, &request)) {
+        /* The lengths cannot be trusted, so the stream cannot be resynchronised */
+        reply(fd, SERVICE_STATUS_ERROR, 0, 0, worker->error, strlen(worker->error), 0.0);
+        return 0;
+    }
+    if (!read_request_body(worker, fd, &request)) return 0;
+
+    if (request.result == SERVICE_RESULT_SHUTDOWN) {
+        reply(fd, SERVICE_STATUS_OK, 0, 0, NULL, 0, 0.0);
+        stop_service(worker->service);
+        wake_poll_loop(worker->service, -1);
+        return 0;
+    }
+
+    double start = quantum_profile_seconds();
+    int success = 0, measured = 0, num_qubits = 0;
+    uint32_t num_records = 0;
+    const void *payload = NULL;
+    size_t payload_bytes = 0;
+    PauliObservable *observable = NULL;
+
+    switch ((ServiceResult)request.result) {
+        case SERVICE_RESULT_COUNTS:
+            success = request.shots > 0 ? count_outcomes(worker, &request, &num_records)
+                                        : job_error(worker, "counts need at least one shot");
+            payload = worker->counts;
+            payload_bytes = num_records * sizeof(ServiceCount);
+            break;
+
+        case SERVICE_RESULT_EXPECTATION:
+            if (request.num_terms == 0) {
+                success = job_error(worker, "expectation values need at least one Pauli term");
+                break;
+            }
+            if (!run_circuit(worker, &request, &measured)) break;
+            observable = quantum_observable_create(worker->state->num_qubits, worker->terms, (int)request.num_terms);
+            if (!observable) {
+                success = job_error(worker, "invalid Pauli terms for %d qubits", worker->state->num_qubits);
+                break;
+            }
+            /* One value per term, in the order sent */
+            payload_bytes = request.num_terms * sizeof(double);
+            payload = reserve((void **)&worker->values, &worker->values_capacity, payload_bytes);
+            if (!payload) {
+                success = job_error(worker, "out of memory for expectation values");
+                break;
+            }
+            quantum_observable_term_expectations(observable, worker->state, worker->values);
+            num_records = request.num_terms;
+            success = 1;
+            break;
+
+        case SERVICE_RESULT_STATE:
+            if (!run_circuit(worker, &request, &measured)) break;
+            quantum_state_materialise(worker->state);
+            payload = worker->state->amplitudes;
+            num_records = (uint32_t)worker->state->num_states;
+            payload_bytes = num_records * sizeof(Complex);
+            success = 1;
+            break;
+
+        default:
+            break;
+    }
+
+    double seconds = quantum_profile_seconds() - start;
+    if (worker->state) num_qubits = worker->state->num_qubits;
+    int sent = success ? reply(fd, SERVICE_STATUS_OK, num_qubits, num_records, payload, payload_bytes, seconds)
+                       : reply(fd, SERVICE_STATUS_ERROR, num_qubits, 0, worker->error, strlen(worker->error), seconds);
+
+    quantum_observable_destroy(observable);
+    release_job_state(worker);
+    return sent;
+}
+
+static void* worker_main(void *argument) {
+    ServiceWorker *worker = argument;
+    Service *service = worker->service;
+
+#ifdef _OPENMP
+    /* Workers share the cores, so each job gets its slice of the OpenMP threads */
+    omp_set_num_threads(service->threads_per_job);
+#endif
+    quantum_random_set_thread_stream(&worker->random);
+
+    for (;;) {
+        int fd = queue_pop(service);
+        if (fd < 0) break;
+
+        if (serve_request(worker, fd)) {
+            wake_poll_loop(service, fd);
+        } else {
+            close_connection(service, fd);
+        }
+    }
+    return NULL;
+}
+
+static void free_worker(ServiceWorker *worker) {
+    free(worker->circuit);
+    free(worker->terms);
+    free(worker->parameters);
+    free(worker->values);
+    free(worker->hits);
+    free(worker->counts);
+}
+
+// =============================================================================
+// POLL LOOP
+// =============================================================================
+
+static int open_listener(const char *path) {
+    struct sockaddr_un address;
+    if (!make_address(path, &address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create service socket\n");
+        return -1;
+    }
+
+    /* A socket file left by a previous run is replaced, a live service is not */
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr *)&address, sizeof(address)) == 0) {
+        fprintf(stderr, "Error: A service is already listening on %s\n", path);
+        close(probe);
+        close(fd);
+        return -1;
+    }
+    if (probe >= 0) close(probe);
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(fd, SERVICE_MAX_CONNECTIONS) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void poll_loop(Service *service) {
+    struct pollfd fds[SERVICE_MAX_CONNECTIONS + 2];
+    int idle[SERVICE_MAX_CONNECTIONS];
+    int num_idle = 0;
+
+    while (!service->stopping && !stop_signalled) {
+        fds[0].fd = service->listen_fd;
+        fds[0].events = POLLIN;
+        fds[1].fd = service->wake_pipe[0];
+        fds[1].events = POLLIN;
+        for (int k = 0; k < num_idle; k++) {
+            fds[k + 2].fd = idle[k];
+            fds[k + 2].events = POLLIN;
+        }
+
+        if (poll(fds, (nfds_t)(num_idle + 2), -1) < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Error: Service poll failed: %s\n", strerror(errno));
+            break;
+        }
+
+        /* Connections with a request (or a hang-up) go to the workers */
+        int kept = 0;
+        for (int k = 0; k < num_idle; k++) {
+            if (fds[k + 2].revents) {
+                queue_push(service, idle[k]);
+            } else {
+                idle[kept++] = idle[k];
+            }
+        }
+        num_idle = kept;
+
+        if (fds[1].revents & POLLIN) {
+            int handed_back[64];
+            ssize_t n = read(service->wake_pipe[0], handed_back, sizeof(handed_back));
+            for (ssize_t k = 0; k < n / (ssize_t)sizeof(int); k++) {
+                if (handed_back[k] >= 0) idle[num_idle++] = handed_back[k];
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(service->listen_fd, NULL, NULL);
+            int accepted = 0;
+            pthread_mutex_lock(&service->lock);
+            if (fd >= 0 && service->num_connections < SERVICE_MAX_CONNECTIONS) {
+                service->num_connections++;
+                accepted = 1;
+            }
+            pthread_mutex_unlock(&service->lock);
+            if (accepted) {
+                idle[num_idle++] = fd;
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    for (int k = 0; k < num_idle; k++) {
+        close(idle[k]);
+    }
+}
+
+int quantum_service_run(const ServiceOptions *options) {
+    if (!options || !options->socket_path) {
+        fprintf(stderr, "Error: Service needs a socket path\n");
+        return 0;
+    }
+    int num_workers = options->num_workers > 0 ? options->num_workers : SERVICE_DEFAULT_WORKERS;
+    if (num_workers > SERVICE_MAX_WORKERS) num_workers = SERVICE_MAX_WORKERS;
+    if (options->preallocate_qubits < 0 || options->preallocate_qubits > MAX_QUBITS) {
+        fprintf(stderr, "Error: Preallocated states must have 1 to %d qubits\n", MAX_QUBITS);
+        return 0;
+    }
+
+    Service *service = calloc(1, sizeof(Service));
+    ServiceWorker *workers = calloc((size_t)num_workers, sizeof(ServiceWorker));
+    pthread_t *threads = calloc((size_t)num_workers, sizeof(pthread_t));
+    if (!service || !workers || !threads) {
+        fprintf(stderr, "Error: Failed to allocate memory for the service\n");
+        free(service);
+        free(workers);
+        free(threads);
+        return 0;
+    }
+
+    service->listen_fd = open_listener(options->socket_path);
+    if (service->listen_fd < 0 || pipe(service->wake_pipe) != 0) {
+        if (service->listen_fd >= 0) close(service->listen_fd);
+        free(service);
+        free(workers);
+        free(threads);
+        return 0;
+    }
+    pthread_mutex_init(&service->lock, NULL);
+    pthread_cond_init(&service->ready, NULL);
+    pthread_mutex_init(&service->pool.lock, NULL);
+
+#ifdef _OPENMP
+    service->threads_per_job = omp_get_max_threads() / num_workers;
+#endif
+    if (service->threads_per_job < 1) service->threads_per_job = 1;
+
+    /* All taken before any is returned, so the pool ends up holding num_workers */
+    QuantumState *prepared[SERVICE_MAX_WORKERS];
+    int num_prepared = 0;
+    while (options->preallocate_qubits > 0 && num_prepared < num_workers &&
+           (prepared[num_prepared] = pool_acquire(&service->pool, options->preallocate_qubits))) {
+        num_prepared++;
+    }
+    for (int k = 0; k < num_prepared; k++) {
+        pool_release(&service->pool, prepared[k]);
+    }
+
+    /* Signals go to the poll loop only, so they interrupt poll() */
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    sigset_t blocked, previous;
+    sigemptyset(&blocked);
+    sigaddset(&blocked, SIGINT);
+    sigaddset(&blocked, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+
+    int started = 0;
+    for (; started < num_workers; started++) {
+        workers[started].service = service;
+        quantum_random_seed(&workers[started].random, (uint64_t)time(NULL), (uint64_t)started);
+        if (pthread_create(&threads[started], NULL, worker_main, &workers[started]) != 0) break;
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    printf("Serving on %s with %d workers, %d OpenMP threads per job\n",
+           options->socket_path, started, service->threads_per_job);
+    fflush(stdout);
+
+    if (started > 0) poll_loop(service);
+
+    stop_service(service);
+    for (int k = 0; k < started; k++) {
+        pthread_join(threads[k], NULL);
+        free_worker(&workers[k]);
+    }
+    /* Connections handed back after the loop stopped are still in the pipe */
+    struct pollfd pending = {service->wake_pipe[0], POLLIN, 0};
+    int handed_back;
+    while (poll(&pending, 1, 0) > 0 && read(service->wake_pipe[0], &handed_back, sizeof(handed_back)) > 0) {
+        if (handed_back >= 0) close(handed_back);
+    }
+    /* Connections still queued were never handed to a worker */
+    while (service->queue_length > 0) {
+        close(service->queue[service->queue_head]);
+        service->queue_head = (service->queue_head + 1) % SERVICE_MAX_CONNECTIONS;
+        service->queue_length--;
+    }
+
+    close(service->listen_fd);
+    close(service->wake_pipe[0]);
+    close(service->wake_pipe[1]);
+    unlink(options->socket_path);
+    pool_destroy(&service->pool);
+    pthread_mutex_destroy(&service->pool.lock);
+    pthread_cond_destroy(&service->ready);
+    pthread_mutex_destroy(&service->lock);
+
+    int success = started == num_workers;
+    free(service);
+    free(workers);
+    free(threads);
+    return success;
+}
+
+// =============================================================================
+// CLIENT
+// =============================================================================
+
+int quantum_service_connect(const char *socket_path) {
+    struct sockaddr_un address;
+    if (!make_address(socket_path, &address)) return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+        fprintf(stderr, "Error: Cannot connect to service at %s: %s\n", socket_path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int quantum_service_submit(int fd, const ServiceRequest *request, const void *circuit,
+                           const PauliTerm *terms, const double *parameters,
+                           ServiceResponse *response, void **payload) {
+    if (!request || !response || !payload) {
+        fprintf(stderr, "Error: Null service request or response\n");
+        return 0;
+    }
+    *payload = NULL;
+
+    if (!write_full(fd, request, sizeof(*request)) ||
+        !write_full(fd, circuit, (size_t)request->circuit_bytes) ||
+        !write_full(fd, terms, request->num_terms * sizeof(PauliTerm)) ||
+        !write_full(fd, parameters, request->num_parameters * sizeof(double)) ||
+        !read_full(fd, response, sizeof(*response))) {
+        fprintf(stderr, "Error: Service connection failed\n");
+        return 0;
+    }
+    if (memcmp(response->magic, SERVICE_RESPONSE_MAGIC, sizeof(response->magic)) != 0) {
+        fprintf(stderr, "Error: Malformed service response\n");
+        return 0;
+    }
+
+    /* Terminated so error text can be printed directly */
+    char *data = malloc((size_t)response->payload_bytes + 1);
+    if (!data) {
+        fprintf(stderr, "Error: Failed to allocate memory for service response\n");
+        return 0;
+    }
+    if (!read_full(fd, data, (size_t)response->payload_bytes)) {
+        fprintf(stderr, "Error: Service connection failed\n");
+        free(data);
+        return 0;
+    }
+    data[response->payload_bytes] = '\0';
+    *payload = data;
+    return 1;
+}
@@ -0,0 +1,155 @@
+#include "quantum_snapshot.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define SNAPSHOT_COPY_BLOCK 4096  /* Amplitudes per memcpy in the parallel fill */
+
+struct QuantumSnapshot {
+    int fd;  /* Anonymous memory file holding the amplitudes */
+    int num_qubits;
+    int num_states;
+    QuantumForm form;
+    Complex *factors;  /* Copy of the source's factors, NULL if it had none */
+    int references;
+};
+
+static size_t snapshot_bytes(const QuantumSnapshot *snapshot) {
+    return (size_t)snapshot->num_states * sizeof(Complex);
+}
+
+/* Writes the dense amplitudes into the file, each thread filling its static share */
+static int fill_snapshot(QuantumSnapshot *snapshot, const Complex *amplitudes) {
+    size_t bytes = snapshot_bytes(snapshot);
+    Complex *target = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, snapshot->fd, 0);
+    if (target == MAP_FAILED) return 0;
+
+    int num_states = snapshot->num_states;
+    int num_blocks = (num_states + SNAPSHOT_COPY_BLOCK - 1) / SNAPSHOT_COPY_BLOCK;
+    #pragma omp parallel for schedule(static) if (num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int b = 0; b < num_blocks; b++) {
+        size_t offset = (size_t)b * SNAPSHOT_COPY_BLOCK;
+        size_t length = (size_t)num_states - offset < SNAPSHOT_COPY_BLOCK ? (size_t)num_states - offset
+                                                                          : SNAPSHOT_COPY_BLOCK;
+        memcpy(target + offset, amplitudes + offset, length * sizeof(Complex));
+    }
+    munmap(target, bytes);
+    return 1;
+}
+
+QuantumSnapshot* quantum_snapshot_create(const QuantumState *state) {
+    if (!state) {
+        fprintf(stderr, "Error: Null state for snapshot\n");
+        return NULL;
+    }
+
+    QuantumSnapshot *snapshot = calloc(1, sizeof(QuantumSnapshot));
+    if (!snapshot) {
+        fprintf(stderr, "Error: Failed to allocate memory for snapshot\n");
+        return NULL;
+    }
+    snapshot->num_qubits = state->num_qubits;
+    snapshot->num_states = state->num_states;
+    snapshot->form = state->form;
+    snapshot->references = 1;
+
+    snapshot->fd = memfd_create("quantum_snapshot", MFD_CLOEXEC);
+    if (snapshot->fd < 0 || ftruncate(snapshot->fd, (off_t)snapshot_bytes(snapshot)) != 0) {
+        fprintf(stderr, "Error: Cannot create a %zu-byte snapshot file\n", snapshot_bytes(snapshot));
+        if (snapshot->fd >= 0) close(snapshot->fd);
+        free(snapshot);
+        return NULL;
+    }
+
+    if (state->factors) {
+        size_t factor_bytes = 2 * (size_t)state->num_qubits * sizeof(Complex);
+        snapshot->factors = malloc(factor_bytes);
+        if (!snapshot->factors) {
+            fprintf(stderr, "Error: Failed to allocate memory for snapshot factors\n");
+            quantum_snapshot_release(snapshot);
+            return NULL;
+        }
+        memcpy(snapshot->factors, state->factors, factor_bytes);
+    }
+
+    /* Stale product-form amplitudes are not copied; the file stays a hole */
+    if (state->form == QUANTUM_FORM_DENSE && !fill_snapshot(snapshot, state->amplitudes)) {
+        fprintf(stderr, "Error: Cannot map the snapshot file\n");
+        quantum_snapshot_release(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+QuantumSnapshot* quantum_snapshot_retain(QuantumSnapshot *snapshot) {
+    if (snapshot) __atomic_add_fetch(&snapshot->references, 1, __ATOMIC_RELAXED);
+    return snapshot;
+}
+
+void quantum_snapshot_release(QuantumSnapshot *snapshot) {
+    if (!snapshot || __atomic_sub_fetch(&snapshot->references, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+    close(snapshot->fd);
+    free(snapshot->factors);
+    free(snapshot);
+}
+
+/* Sets a branch's form and factors back to the snapshot's */
+static int restore_form(QuantumState *branch, const QuantumSnapshot *snapshot) {
+    if (snapshot->factors) {
+        if (!quantum_state_enable_product_form(branch)) return 0;
+        memcpy(branch->factors, snapshot->factors, 2 * (size_t)snapshot->num_qubits * sizeof(Complex));
+    }
+    branch->form = snapshot->form;
+    return 1;
+}
+
+QuantumState* quantum_snapshot_branch(QuantumSnapshot *snapshot) {
+    if (!snapshot) {
+        fprintf(stderr, "Error: Null snapshot\n");
+        return NULL;
+    }
+
+    QuantumState *branch = malloc(sizeof(QuantumState));
+    Complex *amplitudes = mmap(NULL, snapshot_bytes(snapshot), PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                               snapshot->fd, 0);
+    if (!branch || amplitudes == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map a snapshot branch\n");
+        if (amplitudes != MAP_FAILED) munmap(amplitudes, snapshot_bytes(snapshot));
+        free(branch);
+        return NULL;
+    }
+
+    branch->num_qubits = snapshot->num_qubits;
+    branch->num_states = snapshot->num_states;
+    branch->amplitudes = amplitudes;
+    branch->storage = QUANTUM_STORAGE_SNAPSHOT;
+    branch->form = QUANTUM_FORM_DENSE;
+    branch->factors = NULL;
+    branch->snapshot = quantum_snapshot_retain(snapshot);
+
+    if (!restore_form(branch, snapshot)) {
+        quantum_state_destroy(branch);
+        return NULL;
+    }
+    return branch;
+}
+
+int quantum_snapshot_reset(QuantumState *branch) {
+    if (!branch || branch->storage != QUANTUM_STORAGE_SNAPSHOT) {
+        fprintf(stderr, "Error: State is not a snapshot branch\n");
+        return 0;
+    }
+
+    /* Mapping the file again over the same range drops the private pages */
+    QuantumSnapshot *snapshot = branch->snapshot;
+    void *amplitudes = mmap(branch->amplitudes, snapshot_bytes(snapshot), PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_FIXED, snapshot->fd, 0);
+    if (amplitudes == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to remap the snapshot branch\n");
+        return 0;
+    }
+    return restore_form(branch, snapshot);
+}
@@ -1,11 +1,31 @@
 #include "quantum_state.h"
 #include "quantum_utils.h"
+#include "quantum_pool.h"
+#include "quantum_snapshot.h"
+#include "quantum_random.h"
+#include "complex_kernels.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
-#include <time.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
-QuantumState* quantum_state_create(int num_qubits) {
+/* Dense loops hand blocks of this many amplitudes to complex_kernels.h */
+#define STATE_KERNEL_BLOCK 4096
+
+static size_t block_length(const QuantumState *state, int block) {
+    int remaining = state->num_states - block * STATE_KERNEL_BLOCK;
+    return (size_t)(remaining < STATE_KERNEL_BLOCK ? remaining : STATE_KERNEL_BLOCK);
+}
+
+/* Heap state whose amplitudes are a pooled buffer, not yet written */
+static QuantumState* allocate_state(int num_qubits) {
     if (num_qubits < 1 || num_qubits > MAX_QUBITS) {
         fprintf(stderr, "Error: Number of qubits must be between 1 and %d\n", MAX_QUBITS);
         return NULL;
@@ -19,20 +39,92 @@ QuantumState* quantum_state_create(int num_qubits) {
     
     state->num_qubits = num_qubits;
     state->num_states = 1 << num_qubits;  /* 2^num_qubits */
+    state->storage = QUANTUM_STORAGE_HEAP;
+    state->form = QUANTUM_FORM_DENSE;
+    state->factors = NULL;
+    state->snapshot = NULL;
     
-    state->amplitudes = calloc(state->num_states, sizeof(Complex));
+    state->amplitudes = quantum_pool_acquire((size_t)state->num_states);
     if (!state->amplitudes) {
         fprintf(stderr, "Error: Failed to allocate memory for amplitudes\n");
         free(state);
         return NULL;
     }
+    return state;
+}
+
+QuantumState* quantum_state_create(int num_qubits) {
+    QuantumState *state = allocate_state(num_qubits);
+    if (!state) return NULL;
+    
+    /* Parallel first touch places each thread's share of a fresh buffer on its own node */
+    int num_blocks = (state->num_states + STATE_KERNEL_BLOCK - 1) / STATE_KERNEL_BLOCK;
+    #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int b = 0; b < num_blocks; b++) {
+        memset(state->amplitudes + (size_t)b * STATE_KERNEL_BLOCK, 0, block_length(state, b) * sizeof(Complex));
+    }
+    
+    return state;
+}
+
+QuantumState* quantum_state_create_mapped(int num_qubits, const char *path) {
+    if (num_qubits < 1 || num_qubits > MAX_MAPPED_QUBITS) {
+        fprintf(stderr, "Error: Number of mapped qubits must be between 1 and %d\n", MAX_MAPPED_QUBITS);
+        return NULL;
+    }
+    
+    int fd;
+    if (path) {
+        fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    } else {
+        const char *directory = getenv("TMPDIR");
+        char temp_path[4096];
+        snprintf(temp_path, sizeof(temp_path), "%s/quantum_state_XXXXXX", directory ? directory : "/tmp");
+        fd = mkstemp(temp_path);
+        if (fd >= 0) unlink(temp_path);
+    }
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create state file %s\n", path ? path : "(temporary)");
+        return NULL;
+    }
+    
+    QuantumState *state = malloc(sizeof(QuantumState));
+    size_t length = ((size_t)1 << num_qubits) * sizeof(Complex);
+    void *amplitudes = MAP_FAILED;
+    
+    /* The file starts as a hole, so untouched amplitudes read as zero */
+    if (state && ftruncate(fd, (off_t)length) == 0) {
+        amplitudes = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    
+    if (!state || amplitudes == MAP_FAILED) {
+        fprintf(stderr, "Error: Failed to map %zu bytes for quantum state\n", length);
+        free(state);
+        return NULL;
+    }
     
+    state->num_qubits = num_qubits;
+    state->num_states = 1 << num_qubits;
+    state->amplitudes = amplitudes;
+    state->storage = QUANTUM_STORAGE_MAPPED;
+    state->form = QUANTUM_FORM_DENSE;
+    state->factors = NULL;
+    state->snapshot = NULL;
     return state;
 }
 
 void quantum_state_destroy(QuantumState *state) {
     if (state) {
-        free(state->amplitudes);
+        if (state->storage == QUANTUM_STORAGE_MAPPED) {
+            munmap(state->amplitudes, (size_t)state->num_states * sizeof(Complex));
+        } else if (state->storage == QUANTUM_STORAGE_SNAPSHOT) {
+            munmap(state->amplitudes, (size_t)state->num_states * sizeof(Complex));
+            quantum_snapshot_release(state->snapshot);
+        } else {
+            quantum_pool_release(state->amplitudes, (size_t)state->num_states);
+        }
+        free(state->factors);
         free(state);
     }
 }
@@ -40,22 +132,136 @@ void quantum_state_destroy(QuantumState *state) {
 QuantumState* quantum_state_copy(const QuantumState *state) {
     if (!state) return NULL;
     
-    QuantumState *copy = quantum_state_create(state->num_qubits);
+    QuantumState *copy = allocate_state(state->num_qubits);
     if (!copy) return NULL;
     
-    for (int i = 0; i < state->num_states; i++) {
-        copy->amplitudes[i] = state->amplitudes[i];
+    /* A factored copy stays factored and skips the dense copy */
+    if (state->factors) {
+        if (!quantum_state_enable_product_form(copy)) {
+            quantum_state_destroy(copy);
+            return NULL;
+        }
+        memcpy(copy->factors, state->factors, 2 * (size_t)state->num_qubits * sizeof(Complex));
+        copy->form = state->form;
+        if (copy->form == QUANTUM_FORM_PRODUCT) return copy;
+    }
+    
+    /* Each thread copies the blocks its static share of the kernels will touch */
+    int num_blocks = (state->num_states + STATE_KERNEL_BLOCK - 1) / STATE_KERNEL_BLOCK;
+    #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int b = 0; b < num_blocks; b++) {
+        size_t offset = (size_t)b * STATE_KERNEL_BLOCK;
+        memcpy(copy->amplitudes + offset, state->amplitudes + offset, block_length(state, b) * sizeof(Complex));
     }
     
     return copy;
 }
 
+// =============================================================================
+// PRODUCT FORM
+// =============================================================================
+
+int quantum_state_enable_product_form(QuantumState *state) {
+    if (!state) return 0;
+    if (state->factors) return 1;
+    
+    state->factors = malloc(2 * (size_t)state->num_qubits * sizeof(Complex));
+    if (!state->factors) {
+        fprintf(stderr, "Error: Failed to allocate memory for product factors\n");
+        return 0;
+    }
+    return 1;
+}
+
+/* Every qubit set to the same 2-vector */
+static void set_uniform_factors(QuantumState *state, Complex zero, Complex one) {
+    for (int q = 0; q < state->num_qubits; q++) {
+        state->factors[2 * q] = zero;
+        state->factors[2 * q + 1] = one;
+    }
+    state->form = QUANTUM_FORM_PRODUCT;
+}
+
+static void set_basis_factors(QuantumState *state, int index) {
+    for (int q = 0; q < state->num_qubits; q++) {
+        int bit = (index >> q) & 1;
+        state->factors[2 * q + bit] = complex_create(1.0, 0.0);
+        state->factors[2 * q + 1 - bit] = complex_create(0.0, 0.0);
+    }
+    state->form = QUANTUM_FORM_PRODUCT;
+}
+
+/* Doubling: after qubit q the first 2^(q+1) amplitudes hold qubits 0..q */
+static void expand_factors(const QuantumState *state, Complex *amplitudes) {
+    amplitudes[0] = complex_create(1.0, 0.0);
+    for (int q = 0; q < state->num_qubits; q++) {
+        int half = 1 << q;
+        Complex f0 = state->factors[2 * q], f1 = state->factors[2 * q + 1];
+        #pragma omp parallel for schedule(static) if (half >= QUANTUM_PARALLEL_THRESHOLD)
+        for (int i = 0; i < half; i++) {
+            Complex a = amplitudes[i];
+            amplitudes[i + half] = complex_kernel_multiply(a, f1);
+            amplitudes[i] = complex_kernel_multiply(a, f0);
+        }
+    }
+}
+
+void quantum_state_materialise(QuantumState *state) {
+    if (!state || state->form != QUANTUM_FORM_PRODUCT) return;
+    
+    expand_factors(state, state->amplitudes);
+    state->form = QUANTUM_FORM_DENSE;
+}
+
+const Complex* quantum_state_read_amplitudes(const QuantumState *state, Complex **scratch) {
+    *scratch = NULL;
+    if (state->form != QUANTUM_FORM_PRODUCT) return state->amplitudes;
+    
+    *scratch = quantum_pool_acquire((size_t)state->num_states);
+    if (!*scratch) {
+        fprintf(stderr, "Error: Failed to allocate memory for product-form amplitudes\n");
+        return NULL;
+    }
+    expand_factors(state, *scratch);
+    return *scratch;
+}
+
+void quantum_state_release_amplitudes(const QuantumState *state, Complex *scratch) {
+    if (scratch) quantum_pool_release(scratch, (size_t)state->num_states);
+}
+
+static double factor_probability(const QuantumState *state, int qubit, int bit) {
+    return complex_kernel_magnitude_squared(state->factors[2 * qubit + bit]);
+}
+
+static double dense_norm_squared(const QuantumState *state) {
+    int num_blocks = (state->num_states + STATE_KERNEL_BLOCK - 1) / STATE_KERNEL_BLOCK;
+    double sum = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:sum) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int b = 0; b < num_blocks; b++) {
+        sum += complex_kernel_norm_squared(state->amplitudes + (size_t)b * STATE_KERNEL_BLOCK, block_length(state, b));
+    }
+    return sum;
+}
+
+// =============================================================================
+// INITIALISATION AND OPERATIONS
+// =============================================================================
+
 void quantum_state_initialise_zero(QuantumState *state) {
     if (!state) return;
     
+    if (state->factors) {
+        set_basis_factors(state, 0);
+        return;
+    }
+    
     /* Initialise to |00...0⟩ state */
-    for (int i = 0; i < state->num_states; i++) {
-        state->amplitudes[i] = complex_create(0.0, 0.0);
+    int num_states = state->num_states;
+    Complex zero = {0.0, 0.0};
+    #pragma omp parallel for schedule(static) if (num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int i = 0; i < num_states; i++) {
+        state->amplitudes[i] = zero;
     }
     state->amplitudes[0] = complex_create(1.0, 0.0);
 }
@@ -63,9 +269,17 @@ void quantum_state_initialise_zero(QuantumState *state) {
 void quantum_state_initialise_equal_superposition(QuantumState *state) {
     if (!state) return;
     
-    double amplitude = 1.0 / sqrt(state->num_states);
-    for (int i = 0; i < state->num_states; i++) {
-        state->amplitudes[i] = complex_create(amplitude, 0.0);
+    if (state->factors) {
+        double half = 1.0 / sqrt(2.0);
+        set_uniform_factors(state, complex_create(half, 0.0), complex_create(half, 0.0));
+        return;
+    }
+    
+    Complex amplitude = {1.0 / sqrt(state->num_states), 0.0};
+    int num_states = state->num_states;
+    #pragma omp parallel for schedule(static) if (num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int i = 0; i < num_states; i++) {
+        state->amplitudes[i] = amplitude;
     }
 }
 
@@ -74,26 +288,40 @@ void quantum_state_set_amplitude(QuantumState *state, int index, Complex amplitu
         fprintf(stderr, "Error: Invalid state index\n");
         return;
     }
+    quantum_state_materialise(state);
     state->amplitudes[index] = amplitude;
 }
 
 void quantum_state_normalise(QuantumState *state) {
     if (!state) return;
     
-    double norm = 0.0;
-    for (int i = 0; i < state->num_states; i++) {
-        norm += complex_magnitude_squared(state->amplitudes[i]);
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        for (int q = 0; q < state->num_qubits; q++) {
+            double norm = sqrt(factor_probability(state, q, 0) + factor_probability(state, q, 1));
+            if (norm < 1e-10) {
+                fprintf(stderr, "Warning: Cannot normalise zero state\n");
+                return;
+            }
+            for (int bit = 0; bit < 2; bit++) {
+                state->factors[2 * q + bit].real /= norm;
+                state->factors[2 * q + bit].imag /= norm;
+            }
+        }
+        return;
     }
     
-    norm = sqrt(norm);
+    double norm = sqrt(dense_norm_squared(state));
     if (norm < 1e-10) {
         fprintf(stderr, "Warning: Cannot normalise zero state\n");
         return;
     }
     
-    for (int i = 0; i < state->num_states; i++) {
-        state->amplitudes[i].real /= norm;
-        state->amplitudes[i].imag /= norm;
+    double inverse = 1.0 / norm;
+    int num_blocks = (state->num_states + STATE_KERNEL_BLOCK - 1) / STATE_KERNEL_BLOCK;
+    #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int b = 0; b < num_blocks; b++) {
+        complex_kernel_scale_real(state->amplitudes + (size_t)b * STATE_KERNEL_BLOCK,
+                                  block_length(state, b), 1, inverse);
     }
 }
 
@@ -101,50 +329,83 @@ double quantum_state_get_probability(const QuantumState *state, int index) {
     if (!state || index < 0 || index >= state->num_states) {
         return 0.0;
     }
-    return complex_magnitude_squared(state->amplitudes[index]);
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        double probability = 1.0;
+        for (int q = 0; q < state->num_qubits; q++) {
+            probability *= factor_probability(state, q, (index >> q) & 1);
+        }
+        return probability;
+    }
+    return complex_kernel_magnitude_squared(state->amplitudes[index]);
 }
 
 int quantum_state_is_normalised(const QuantumState *state, double tolerance) {
     if (!state) return 0;
     
     double norm_squared = 0.0;
-    for (int i = 0; i < state->num_states; i++) {
-        norm_squared += complex_magnitude_squared(state->amplitudes[i]);
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        norm_squared = 1.0;
+        for (int q = 0; q < state->num_qubits; q++) {
+            norm_squared *= factor_probability(state, q, 0) + factor_probability(state, q, 1);
+        }
+        return fabs(norm_squared - 1.0) < tolerance;
     }
     
+    norm_squared = dense_norm_squared(state);
     return fabs(norm_squared - 1.0) < tolerance;
 }
 
 int quantum_state_measure_all(QuantumState *state) {
     if (!state) return -1;
     
-    static int seed_initialised = 0;
-    if (!seed_initialised) {
-        srand((unsigned int)time(NULL));
-        seed_initialised = 1;
+    /* Qubits of a product state are independent, so each is sampled alone */
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        int result = 0;
+        for (int q = 0; q < state->num_qubits; q++) {
+            double random = quantum_random_uniform();
+            if (random >= factor_probability(state, q, 0)) result |= 1 << q;
+        }
+        set_basis_factors(state, result);
+        return result;
     }
     
-    double random = (double)rand() / RAND_MAX;
+    double random = quantum_random_uniform();
     double cumulative_probability = 0.0;
+    int outcome = -1;
     
-    for (int i = 0; i < state->num_states; i++) {
-        cumulative_probability += quantum_state_get_probability(state, i);
-        if (random <= cumulative_probability) {
-            /* Collapse to measured state */
-            for (int j = 0; j < state->num_states; j++) {
-                state->amplitudes[j] = complex_create(0.0, 0.0);
+    /* Whole blocks are skipped on their vectorised sums; only the block
+     * holding the sample is scanned amplitude by amplitude */
+    int num_blocks = (state->num_states + STATE_KERNEL_BLOCK - 1) / STATE_KERNEL_BLOCK;
+    for (int b = 0; b < num_blocks && outcome < 0; b++) {
+        const Complex *block = state->amplitudes + (size_t)b * STATE_KERNEL_BLOCK;
+        size_t length = block_length(state, b);
+        double block_probability = complex_kernel_norm_squared(block, length);
+        
+        if (cumulative_probability + block_probability < random) {
+            cumulative_probability += block_probability;
+            continue;
+        }
+        for (size_t k = 0; k < length; k++) {
+            cumulative_probability += complex_kernel_magnitude_squared(block[k]);
+            if (random <= cumulative_probability) {
+                outcome = b * STATE_KERNEL_BLOCK + (int)k;
+                break;
             }
-            state->amplitudes[i] = complex_create(1.0, 0.0);
-            return i;
         }
     }
     
-    /* Fallback to last state (should rarely happen) */
-    for (int j = 0; j < state->num_states; j++) {
-        state->amplitudes[j] = complex_create(0.0, 0.0);
+    if (outcome < 0) outcome = state->num_states - 1;  /* Fallback (should rarely happen) */
+    
+    /* A basis state needs no dense collapse when it can be factored */
+    if (state->factors) {
+        set_basis_factors(state, outcome);
+        return outcome;
     }
-    state->amplitudes[state->num_states - 1] = complex_create(1.0, 0.0);
-    return state->num_states - 1;
+    
+    /* Collapse to measured state */
+    memset(state->amplitudes, 0, (size_t)state->num_states * sizeof(Complex));
+    state->amplitudes[outcome] = complex_create(1.0, 0.0);
+    return outcome;
 }
 
 int quantum_state_measure_qubit(QuantumState *state, int qubit_index) {
@@ -153,27 +414,32 @@ int quantum_state_measure_qubit(QuantumState *state, int qubit_index) {
         return -1;
     }
     
+    if (state->form == QUANTUM_FORM_PRODUCT) {
+        /* Factors are kept normalised, so the qubit's own 2-vector gives the odds */
+        double random = quantum_random_uniform();
+        int measured_value = (random < factor_probability(state, qubit_index, 0)) ? 0 : 1;
+        Complex *factor = state->factors + 2 * qubit_index;
+        double magnitude = sqrt(complex_kernel_magnitude_squared(factor[measured_value]));
+        
+        if (magnitude < 1e-10) {
+            fprintf(stderr, "Warning: Trying to measure qubit with zero probability\n");
+            return measured_value;
+        }
+        factor[measured_value].real /= magnitude;
+        factor[measured_value].imag /= magnitude;
+        factor[1 - measured_value] = complex_create(0.0, 0.0);
+        return measured_value;
+    }
+    
     /* Calculate probabilities for |0⟩ and |1⟩ */
-    double prob_0 = 0.0, prob_1 = 0.0;
+    double marginal[2];
     int qubit_mask = 1 << qubit_index;
     
-    for (int i = 0; i < state->num_states; i++) {
-        double prob = quantum_state_get_probability(state, i);
-        if (i & qubit_mask) {
-            prob_1 += prob;
-        } else {
-            prob_0 += prob;
-        }
-    }
+    if (!quantum_state_marginal(state, (unsigned int)qubit_mask, marginal)) return -1;
+    double prob_0 = marginal[0], prob_1 = marginal[1];
     
     /* Measure */
-    static int seed_initialised = 0;
-    if (!seed_initialised) {
-        srand((unsigned int)time(NULL));
-        seed_initialised = 1;
-    }
-    
-    double random = (double)rand() / RAND_MAX;
+    double random = quantum_random_uniform();
     int measured_value = (random < prob_0) ? 0 : 1;
     
     /* Collapse state */
@@ -184,45 +450,629 @@ int quantum_state_measure_qubit(QuantumState *state, int qubit_index) {
         return measured_value;
     }
     
+    /* Zero the half incompatible with the result and renormalise the rest;
+     * each half is a run of qubit_mask amplitudes, or every other one for qubit 0 */
+    Complex *kept = state->amplitudes + (measured_value ? qubit_mask : 0);
+    Complex *dropped = state->amplitudes + (measured_value ? 0 : qubit_mask);
+    double inverse = 1.0 / normalisation;
+    
+    if (qubit_mask == 1) {
+        complex_kernel_scale_real(kept, (size_t)state->num_states / 2, 2, inverse);
+        complex_kernel_zero(dropped, (size_t)state->num_states / 2, 2);
+    } else {
+        int num_blocks = state->num_states / (2 * qubit_mask);
+        #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+        for (int b = 0; b < num_blocks; b++) {
+            size_t base = (size_t)b * 2 * qubit_mask;
+            complex_kernel_scale_real(kept + base, (size_t)qubit_mask, 1, inverse);
+            complex_kernel_zero(dropped + base, (size_t)qubit_mask, 1);
+        }
+    }
+    
+    return measured_value;
+}
+
+// =============================================================================
+// SAMPLING
+// =============================================================================
+
+double quantum_state_cumulative(const QuantumState *state, double *cumulative) {
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return -1.0;
+
+    double total = 0.0;
     for (int i = 0; i < state->num_states; i++) {
-        if (((i & qubit_mask) != 0) != (measured_value != 0)) {
-            /* This state is incompatible with measurement result */
-            state->amplitudes[i] = complex_create(0.0, 0.0);
+        total += complex_kernel_magnitude_squared(amplitudes[i]);
+        cumulative[i] = total;
+    }
+    quantum_state_release_amplitudes(state, scratch);
+    return total;
+}
+
+int quantum_state_draw(const double *cumulative, int num_states, double total, QuantumRandom *random) {
+    /* u in (0, total], so outcomes of zero probability are never drawn */
+    double u = total * (1.0 - quantum_random_double(random));
+
+    /* First index whose cumulative probability reaches u */
+    int low = 0, high = num_states - 1;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (cumulative[middle] < u) {
+            low = middle + 1;
         } else {
-            /* Renormalise remaining amplitudes */
-            state->amplitudes[i].real /= normalisation;
-            state->amplitudes[i].imag /= normalisation;
+            high = middle;
         }
     }
+    return low;
+}
+
+int quantum_state_sample(const QuantumState *state, QuantumRandom *random, int shots, double *scratch, int *out) {
+    if (!state || !random || !scratch || !out) {
+        fprintf(stderr, "Error: Null state, random stream or buffer\n");
+        return 0;
+    }
+
+    double total = quantum_state_cumulative(state, scratch);
+    if (total < 0.0) return 0;
+    for (int shot = 0; shot < shots; shot++) {
+        out[shot] = quantum_state_draw(scratch, state->num_states, total, random);
+    }
+    return 1;
+}
+
+// =============================================================================
+// MARGINALS
+// =============================================================================
+
+/* Byte-wise lookup tables for pext (gather the mask's bits of an index into
+ * the low bits) and pdep (spread low bits out to the mask's positions) */
+typedef struct {
+    unsigned int bytes[4][256];
+} BitTable;
+
+static unsigned int gather_bits(unsigned int value, unsigned int mask) {
+    unsigned int result = 0;
+    for (unsigned int bit = 1; mask; mask &= mask - 1, bit <<= 1) {
+        if (value & mask & -mask) result |= bit;
+    }
+    return result;
+}
+
+static unsigned int scatter_bits(unsigned int value, unsigned int mask) {
+    unsigned int result = 0;
+    for (unsigned int bit = 1; mask; mask &= mask - 1, bit <<= 1) {
+        if (value & bit) result |= mask & -mask;
+    }
+    return result;
+}
+
+static void build_gather_table(BitTable *table, unsigned int mask) {
+    for (int b = 0; b < 4; b++) {
+        for (unsigned int v = 0; v < 256; v++) {
+            table->bytes[b][v] = gather_bits(v << (8 * b), mask);
+        }
+    }
+}
+
+static void build_scatter_table(BitTable *table, unsigned int mask) {
+    for (int b = 0; b < 4; b++) {
+        for (unsigned int v = 0; v < 256; v++) {
+            table->bytes[b][v] = scatter_bits(v << (8 * b), mask);
+        }
+    }
+}
+
+static inline unsigned int table_lookup(const BitTable *table, unsigned int value) {
+    return table->bytes[0][value & 0xFF] | table->bytes[1][(value >> 8) & 0xFF] |
+           table->bytes[2][(value >> 16) & 0xFF] | table->bytes[3][value >> 24];
+}
+
+/* Runs of 2^low amplitudes below the lowest selected qubit share a bin, so
+ * long runs are summed as contiguous blocks before one histogram update.
+ * Short runs are walked 256 amplitudes at a time instead, with the bin split
+ * into a per-chunk high part and a lookup on the low byte. */
+static int marginal_histograms(const QuantumState *state, unsigned int qubit_mask, int num_bins, double *out) {
+    int low = __builtin_ctz(qubit_mask);
+    size_t block = low >= 3 ? (size_t)1 << low : 256;
+    if (block > (size_t)state->num_states) block = (size_t)state->num_states;
+    size_t num_blocks = (size_t)state->num_states / block;
+    int parallel = state->num_states >= QUANTUM_PARALLEL_THRESHOLD;
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (parallel) num_threads = omp_get_max_threads();
+#endif
+
+    BitTable *table = malloc(sizeof(BitTable));
+    double *histograms = calloc((size_t)num_threads * num_bins, sizeof(double));
+    if (!table || !histograms) {
+        fprintf(stderr, "Error: Failed to allocate memory for marginal histograms\n");
+        free(table);
+        free(histograms);
+        return 0;
+    }
+    build_gather_table(table, qubit_mask);
+
+    const Complex *amplitudes = state->amplitudes;
+    #pragma omp parallel num_threads(num_threads) if (parallel)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double *histogram = histograms + (size_t)thread * num_bins;
+        const unsigned int *low_byte = table->bytes[0];
+
+        #pragma omp for schedule(static)
+        for (size_t b = 0; b < num_blocks; b++) {
+            const Complex *run = amplitudes + b * block;
+            unsigned int bin = table_lookup(table, (unsigned int)(b * block));
+
+            if (low >= 3) {
+                double sum = 0.0;
+                #pragma omp simd reduction(+:sum)
+                for (size_t j = 0; j < block; j++) {
+                    sum += run[j].real * run[j].real + run[j].imag * run[j].imag;
+                }
+                histogram[bin] += sum;
+            } else {
+                for (size_t j = 0; j < block; j++) {
+                    histogram[bin | low_byte[j]] += run[j].real * run[j].real + run[j].imag * run[j].imag;
+                }
+            }
+        }
+    }
+
+    /* Merged in thread order, so results do not depend on timing */
+    for (int bin = 0; bin < num_bins; bin++) {
+        double sum = 0.0;
+        for (int t = 0; t < num_threads; t++) sum += histograms[(size_t)t * num_bins + bin];
+        out[bin] = sum;
+    }
+
+    free(table);
+    free(histograms);
+    return 1;
+}
+
+/* Each bin sums its own 2^(n-k) amplitudes, found by spreading the bin over
+ * the selected qubits and adding precomputed offsets for the others */
+static int marginal_by_bin(const QuantumState *state, unsigned int qubit_mask, int num_bins, double *out) {
+    unsigned int rest_mask = (unsigned int)(state->num_states - 1) & ~qubit_mask;
+    int num_rest = state->num_states / num_bins;
+
+    BitTable *table = malloc(sizeof(BitTable));
+    unsigned int *offsets = malloc((size_t)num_rest * sizeof(unsigned int));
+    if (!table || !offsets) {
+        fprintf(stderr, "Error: Failed to allocate memory for marginal offsets\n");
+        free(table);
+        free(offsets);
+        return 0;
+    }
+    build_scatter_table(table, qubit_mask);
+    for (int r = 0; r < num_rest; r++) offsets[r] = scatter_bits((unsigned int)r, rest_mask);
+
+    const Complex *amplitudes = state->amplitudes;
+    #pragma omp parallel for schedule(static) if (state->num_states >= QUANTUM_PARALLEL_THRESHOLD)
+    for (int bin = 0; bin < num_bins; bin++) {
+        const Complex *base = amplitudes + table_lookup(table, (unsigned int)bin);
+        double sum = 0.0;
+        for (int r = 0; r < num_rest; r++) {
+            Complex a = base[offsets[r]];
+            sum += a.real * a.real + a.imag * a.imag;
+        }
+        out[bin] = sum;
+    }
+
+    free(table);
+    free(offsets);
+    return 1;
+}
+
+/* A product state's marginal is itself a product: each bin multiplies the
+ * selected qubits' probabilities, scaled by the other qubits' norms */
+static int marginal_from_factors(const QuantumState *state, unsigned int qubit_mask, double *out) {
+    double rest = 1.0;
+    for (int q = 0; q < state->num_qubits; q++) {
+        if (!(qubit_mask & (1u << q))) rest *= factor_probability(state, q, 0) + factor_probability(state, q, 1);
+    }
     
-    return measured_value;
+    out[0] = rest;
+    int size = 1;
+    for (int q = 0; q < state->num_qubits; q++) {
+        if (!(qubit_mask & (1u << q))) continue;
+        double p0 = factor_probability(state, q, 0), p1 = factor_probability(state, q, 1);
+        for (int bin = 0; bin < size; bin++) {
+            out[bin + size] = out[bin] * p1;
+            out[bin] *= p0;
+        }
+        size *= 2;
+    }
+    return 1;
+}
+
+int quantum_state_marginal(const QuantumState *state, unsigned int qubit_mask, double *out) {
+    if (!state || !out) {
+        fprintf(stderr, "Error: Null state or output\n");
+        return 0;
+    }
+    if (qubit_mask == 0 || (qubit_mask & ~(unsigned int)(state->num_states - 1))) {
+        fprintf(stderr, "Error: Invalid qubit mask 0x%x for %d qubits\n", qubit_mask, state->num_qubits);
+        return 0;
+    }
+
+    if (state->form == QUANTUM_FORM_PRODUCT) return marginal_from_factors(state, qubit_mask, out);
+    int k = __builtin_popcount(qubit_mask);
+    int num_bins = 1 << k;
+    if (k <= MARGINAL_PRIVATE_QUBITS) return marginal_histograms(state, qubit_mask, num_bins, out);
+    return marginal_by_bin(state, qubit_mask, num_bins, out);
+}
+
+// =============================================================================
+// TOP-K
+// =============================================================================
+
+/* Strict order: more likely first, then lower index, so results are unique */
+static inline int outcome_before(const StateOutcome *a, const StateOutcome *b) {
+    return a->probability > b->probability || (a->probability == b->probability && a->index < b->index);
+}
+
+/* Min-heap on outcome_before: the root is the weakest outcome kept */
+static void heap_sift_down(StateOutcome *heap, int size, int i) {
+    for (;;) {
+        int weakest = i, left = 2 * i + 1, right = left + 1;
+        if (left < size && outcome_before(&heap[weakest], &heap[left])) weakest = left;
+        if (right < size && outcome_before(&heap[weakest], &heap[right])) weakest = right;
+        if (weakest == i) return;
+        StateOutcome swap = heap[i];
+        heap[i] = heap[weakest];
+        heap[weakest] = swap;
+        i = weakest;
+    }
+}
+
+static void heap_offer(StateOutcome *heap, int *size, int k, const StateOutcome *outcome) {
+    if (*size < k) {
+        int i = (*size)++;
+        heap[i] = *outcome;
+        while (i > 0 && outcome_before(&heap[(i - 1) / 2], &heap[i])) {
+            StateOutcome swap = heap[i];
+            heap[i] = heap[(i - 1) / 2];
+            heap[(i - 1) / 2] = swap;
+            i = (i - 1) / 2;
+        }
+    } else if (outcome_before(outcome, &heap[0])) {
+        heap[0] = *outcome;
+        heap_sift_down(heap, k, 0);
+    }
+}
+
+int quantum_state_top_k(const QuantumState *state, int k, StateOutcome *out) {
+    if (!state || !out || k < 0) {
+        fprintf(stderr, "Error: Invalid top-k query\n");
+        return 0;
+    }
+    if (k > state->num_states) k = state->num_states;
+    if (k == 0) return 0;
+
+    int parallel = state->num_states >= QUANTUM_PARALLEL_THRESHOLD;
+    int num_threads = 1;
+#ifdef _OPENMP
+    if (parallel) num_threads = omp_get_max_threads();
+#endif
+
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0;
+
+    StateOutcome *heaps = malloc((size_t)num_threads * k * sizeof(StateOutcome));
+    int *sizes = calloc((size_t)num_threads, sizeof(int));
+    if (!heaps || !sizes) {
+        fprintf(stderr, "Error: Failed to allocate memory for top-k heaps\n");
+        free(heaps);
+        free(sizes);
+        quantum_state_release_amplitudes(state, scratch);
+        return 0;
+    }
+
+    int num_states = state->num_states;
+    #pragma omp parallel num_threads(num_threads) if (parallel)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        StateOutcome *heap = heaps + (size_t)thread * k;
+        int size = 0;
+
+        #pragma omp for schedule(static)
+        for (int i = 0; i < num_states; i++) {
+            StateOutcome outcome;
+            outcome.probability = amplitudes[i].real * amplitudes[i].real + amplitudes[i].imag * amplitudes[i].imag;
+            /* Most amplitudes lose to a full heap's root on probability alone */
+            if (size == k && outcome.probability < heap[0].probability) continue;
+            outcome.index = i;
+            outcome.amplitude = amplitudes[i];
+            heap_offer(heap, &size, k, &outcome);
+        }
+        sizes[thread] = size;
+    }
+
+    /* Merge the other heaps into the first, then drain it weakest-first from the back */
+    int size = sizes[0];
+    for (int t = 1; t < num_threads; t++) {
+        for (int i = 0; i < sizes[t]; i++) heap_offer(heaps, &size, k, &heaps[(size_t)t * k + i]);
+    }
+    int count = size;
+    while (size > 0) {
+        out[--size] = heaps[0];
+        heaps[0] = heaps[size];
+        heap_sift_down(heaps, size, 0);
+    }
+
+    free(heaps);
+    free(sizes);
+    quantum_state_release_amplitudes(state, scratch);
+    return count;
+}
+
+/* Shared by the print functions; returns outcomes above the display threshold */
+static int print_outcomes(const QuantumState *state, StateOutcome *outcomes) {
+    int count = quantum_state_top_k(state, STATE_PRINT_LIMIT, outcomes);
+    int shown = 0;
+    while (shown < count && outcomes[shown].probability > 1e-10) shown++;
+    return shown;
+}
+
+static void print_truncation(const QuantumState *state, int shown) {
+    if (shown == STATE_PRINT_LIMIT && state->num_states > STATE_PRINT_LIMIT) {
+        printf("(the %d most likely of %d basis states)\n", STATE_PRINT_LIMIT, state->num_states);
+    }
 }
 
 void quantum_state_print(const QuantumState *state) {
     if (!state) return;
     
+    StateOutcome outcomes[STATE_PRINT_LIMIT];
+    int shown = print_outcomes(state, outcomes);
+    
     printf("Quantum State (%d qubits):\n", state->num_qubits);
-    for (int i = 0; i < state->num_states; i++) {
-        if (complex_magnitude_squared(state->amplitudes[i]) > 1e-10) {
-            printf("|");
-            quantum_utils_print_binary(i, state->num_qubits);
-            printf("⟩: ");
-            complex_print(state->amplitudes[i]);
-            printf("\n");
-        }
+    for (int i = 0; i < shown; i++) {
+        printf("|");
+        quantum_utils_print_binary(outcomes[i].index, state->num_qubits);
+        printf("⟩: ");
+        complex_print(outcomes[i].amplitude);
+        printf("\n");
     }
+    print_truncation(state, shown);
 }
 
 void quantum_state_print_probabilities(const QuantumState *state) {
     if (!state) return;
     
+    StateOutcome outcomes[STATE_PRINT_LIMIT];
+    int shown = print_outcomes(state, outcomes);
+    
     printf("State Probabilities:\n");
-    for (int i = 0; i < state->num_states; i++) {
-        double prob = quantum_state_get_probability(state, i);
-        if (prob > 1e-10) {
-            printf("|");
-            quantum_utils_print_binary(i, state->num_qubits);
-            printf("⟩: %.6f\n", prob);
+    for (int i = 0; i < shown; i++) {
+        printf("|");
+        quantum_utils_print_binary(outcomes[i].index, state->num_qubits);
+        printf("⟩: %.6f\n", outcomes[i].probability);
+    }
+    print_truncation(state, shown);
+}
+
+// =============================================================================
+// CHECKPOINTS
+// =============================================================================
+
+#define CHECKPOINT_MAGIC "QSTATECK"
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_ALIGNMENT 4096
+#define CHECKPOINT_CHUNK_PRESENT 1u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_qubits;
+    uint64_t chunk_bytes;
+    uint64_t num_chunks;
+    uint64_t data_offset;  /* Chunk i starts at data_offset + i * chunk_bytes */
+} CheckpointHeader;
+
+typedef struct {
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t checksum;
+} CheckpointChunk;
+
+/* Word-wise FNV-1a; chunks are always a whole number of amplitudes */
+static uint64_t checkpoint_checksum(const void *data, size_t length) {
+    const uint64_t *words = data;
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length / sizeof(uint64_t); i++) {
+        hash = (hash ^ words[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static int is_zero_chunk(const void *data, size_t length) {
+    const uint64_t *words = data;
+    for (size_t i = 0; i < length / sizeof(uint64_t); i++) {
+        if (words[i]) return 0;
+    }
+    return 1;
+}
+
+static int write_full(int fd, const void *data, size_t length, off_t offset) {
+    const char *bytes = data;
+    while (length > 0) {
+        ssize_t written = pwrite(fd, bytes, length, offset);
+        if (written <= 0) return 0;
+        bytes += written;
+        length -= (size_t)written;
+        offset += written;
+    }
+    return 1;
+}
+
+static int read_full(int fd, void *data, size_t length, off_t offset) {
+    char *bytes = data;
+    while (length > 0) {
+        ssize_t count = pread(fd, bytes, length, offset);
+        if (count <= 0) return 0;
+        bytes += count;
+        length -= (size_t)count;
+        offset += count;
+    }
+    return 1;
+}
+
+static void checkpoint_layout(int num_qubits, CheckpointHeader *header) {
+    size_t state_bytes = ((size_t)1 << num_qubits) * sizeof(Complex);
+    size_t table_end;
+
+    memset(header, 0, sizeof(CheckpointHeader));
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic));
+    header->version = CHECKPOINT_VERSION;
+    header->num_qubits = (uint32_t)num_qubits;
+    header->chunk_bytes = state_bytes < CHECKPOINT_CHUNK_BYTES ? state_bytes : CHECKPOINT_CHUNK_BYTES;
+    header->num_chunks = state_bytes / header->chunk_bytes;
+
+    table_end = sizeof(CheckpointHeader) + header->num_chunks * sizeof(CheckpointChunk);
+    header->data_offset = (table_end + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+}
+
+int quantum_state_save(const QuantumState *state, const char *path) {
+    if (!state || !path) {
+        fprintf(stderr, "Error: Null state or checkpoint path\n");
+        return 0;
+    }
+
+    Complex *scratch;
+    const Complex *amplitudes = quantum_state_read_amplitudes(state, &scratch);
+    if (!amplitudes) return 0;
+
+    CheckpointHeader header;
+    checkpoint_layout(state->num_qubits, &header);
+
+    size_t table_bytes = header.data_offset - sizeof(CheckpointHeader);
+    CheckpointChunk *table = calloc(1, table_bytes);
+    char *temp_path = malloc(strlen(path) + 5);
+    if (!table || !temp_path) {
+        fprintf(stderr, "Error: Failed to allocate memory for checkpoint\n");
+        free(table);
+        free(temp_path);
+        quantum_state_release_amplitudes(state, scratch);
+        return 0;
+    }
+    sprintf(temp_path, "%s.tmp", path);
+
+    int fd = open(temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot create checkpoint %s\n", temp_path);
+        free(table);
+        free(temp_path);
+        quantum_state_release_amplitudes(state, scratch);
+        return 0;
+    }
+
+    const char *data = (const char *)amplitudes;
+    long long num_chunks = (long long)header.num_chunks;
+    int failures = 0;
+
+    /* Each chunk has a fixed offset, so chunks are checked and written independently */
+    #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+    for (long long c = 0; c < num_chunks; c++) {
+        const char *chunk = data + c * header.chunk_bytes;
+        if (is_zero_chunk(chunk, header.chunk_bytes)) continue;
+
+        table[c].flags = CHECKPOINT_CHUNK_PRESENT;
+        table[c].checksum = checkpoint_checksum(chunk, header.chunk_bytes);
+        if (!write_full(fd, chunk, header.chunk_bytes, (off_t)(header.data_offset + c * header.chunk_bytes))) {
+            failures++;
         }
     }
-}
\ No newline at end of file
+
+    /* Trailing zero chunks become a hole rather than being written */
+    off_t file_size = (off_t)(header.data_offset + header.num_chunks * header.chunk_bytes);
+    int success = failures == 0 &&
+                  write_full(fd, &header, sizeof(CheckpointHeader), 0) &&
+                  write_full(fd, table, table_bytes, sizeof(CheckpointHeader)) &&
+                  ftruncate(fd, file_size) == 0 &&
+                  fsync(fd) == 0;
+    if (close(fd) != 0) success = 0;
+
+    if (success && rename(temp_path, path) != 0) success = 0;
+    if (!success) {
+        fprintf(stderr, "Error: Failed to write checkpoint %s\n", path);
+        unlink(temp_path);
+    }
+
+    free(table);
+    free(temp_path);
+    quantum_state_release_amplitudes(state, scratch);
+    return success;
+}
+
+QuantumState* quantum_state_restore(const char *path) {
+    int fd = path ? open(path, O_RDONLY) : -1;
+    if (fd < 0) {
+        fprintf(stderr, "Error: Cannot open checkpoint %s\n", path ? path : "(null)");
+        return NULL;
+    }
+
+    CheckpointHeader header, expected;
+    if (!read_full(fd, &header, sizeof(CheckpointHeader), 0) ||
+        memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION ||
+        header.num_qubits < 1 || header.num_qubits > MAX_QUBITS) {
+        fprintf(stderr, "Error: %s is not a valid checkpoint\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    checkpoint_layout((int)header.num_qubits, &expected);
+    if (memcmp(&header, &expected, sizeof(CheckpointHeader)) != 0) {
+        fprintf(stderr, "Error: Checkpoint %s has an unsupported layout\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t table_bytes = header.num_chunks * sizeof(CheckpointChunk);
+    CheckpointChunk *table = malloc(table_bytes);
+    QuantumState *state = table ? quantum_state_create((int)header.num_qubits) : NULL;
+    if (!state || !read_full(fd, table, table_bytes, sizeof(CheckpointHeader))) {
+        fprintf(stderr, "Error: Failed to read checkpoint %s\n", path);
+        quantum_state_destroy(state);
+        free(table);
+        close(fd);
+        return NULL;
+    }
+
+    /* Chunks are read straight into the zeroed amplitude buffer; elided chunks stay zero */
+    char *data = (char *)state->amplitudes;
+    long long num_chunks = (long long)header.num_chunks;
+    int failures = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+    for (long long c = 0; c < num_chunks; c++) {
+        if (!(table[c].flags & CHECKPOINT_CHUNK_PRESENT)) continue;
+
+        char *chunk = data + c * header.chunk_bytes;
+        if (!read_full(fd, chunk, header.chunk_bytes, (off_t)(header.data_offset + c * header.chunk_bytes)) ||
+            checkpoint_checksum(chunk, header.chunk_bytes) != table[c].checksum) {
+            failures++;
+        }
+    }
+
+    free(table);
+    close(fd);
+
+    if (failures > 0) {
+        fprintf(stderr, "Error: Checkpoint %s is truncated or corrupt (%d bad chunks)\n", path, failures);
+        quantum_state_destroy(state);
+        return NULL;
+    }
+    return state;
+}
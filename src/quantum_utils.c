@@ -109,42 +109,35 @@ InputParseResult quantum_utils_parse_user_input(const char* prompt, const char**
 }
 
 void quantum_utils_display_probabilities(QuantumState *state, const char** database, int db_size, int target) {
-    typedef struct { int idx; double prob; } ItemProb;
-    ItemProb *items = malloc(db_size * sizeof(ItemProb));
-    
-    for (int i = 0; i < db_size; i++) {
-        items[i] = (ItemProb){i, quantum_state_get_probability(state, i)};
-    }
-    
-    // Sort by probability (descending)
-    for (int i = 0; i < db_size - 1; i++) {
-        for (int j = i + 1; j < db_size; j++) {
-            if (items[j].prob > items[i].prob) {
-                ItemProb temp = items[i];
-                items[i] = items[j];
-                items[j] = temp;
-            }
-        }
-    }
+    StateOutcome outcomes[10];
+    int count = quantum_state_top_k(state, 10, outcomes);
     
     printf("\n Final probabilities:\n");
     printf("╔═════╤═══════════════╤══════════╗\n");
     printf("║  #  │ Item          │   Prob   ║\n");
     printf("╠═════╪═══════════════╪══════════╣\n");
     
-    int items_shown = 0;
-    for (int i = 0; i < db_size && items_shown < 10; i++) {
-        if (items[i].prob > 0.001 || items[i].idx == target) {
-            printf("║ %2d  │ %-13s │  %5.1f%%  ║", 
-                   items[i].idx, database[items[i].idx], items[i].prob * 100);
-            if (items[i].idx == target) printf(" ← TARGET");
+    int items_shown = 0, target_shown = 0;
+    for (int i = 0; i < count; i++) {
+        int idx = outcomes[i].index;
+        if (idx < db_size && (outcomes[i].probability > 0.001 || idx == target)) {
+            printf("║ %2d  │ %-13s │  %5.1f%%  ║", idx, database[idx], outcomes[i].probability * 100);
+            if (idx == target) {
+                printf(" ← TARGET");
+                target_shown = 1;
+            }
             printf("\n");
             items_shown++;
         }
     }
     
+    /* A target outside the top ten is still listed while there is room */
+    if (!target_shown && items_shown < 10 && target >= 0 && target < db_size) {
+        printf("║ %2d  │ %-13s │  %5.1f%%  ║ ← TARGET\n",
+               target, database[target], quantum_state_get_probability(state, target) * 100);
+    }
+    
     printf("╚═════╧═══════════════╧══════════╝\n");
-    free(items);
 }
 
 // =============================================================================
@@ -308,6 +301,7 @@ void quantum_utils_add_grover_diffusion(QuantumCircuit *circuit, int num_qubits)
 void quantum_utils_apply_grover_oracle(QuantumState *state, int target) {
     if (!state || target < 0 || target >= state->num_states) return;
     
+    quantum_state_materialise(state);
     state->amplitudes[target].real = -state->amplitudes[target].real;
     state->amplitudes[target].imag = -state->amplitudes[target].imag;
 }
@@ -315,6 +309,7 @@ void quantum_utils_apply_grover_oracle(QuantumState *state, int target) {
 
 void quantum_utils_apply_grover_diffusion(QuantumState *state, int* valid_states, int num_valid) {
     if (!state) return;
+    quantum_state_materialise(state);
     
     Complex sum = {0.0, 0.0};
     int states_to_process;
@@ -432,6 +427,7 @@ void quantum_utils_run_grover_algorithm(QuantumState *state) {
     // Initialize superposition over database states
     printf("\nStep 1: Initialize superposition over database states\n");
     quantum_state_initialise_zero(state);
+    quantum_state_materialise(state);
     
     double amplitude = 1.0 / sqrt(db_size);
     for (int i = 0; i < db_size; i++) {
@@ -451,7 +447,6 @@ void quantum_utils_run_grover_algorithm(QuantumState *state) {
     }
     
     printf("\nStep 2: Grover iterations (%d needed)\n", iterations);
-           (double)db_size / (2.0 * iterations));
     
     for (int iter = 0; iter < iterations; iter++) {
         printf("Iteration %d/%d:\n", iter + 1, iterations);
@@ -534,9 +529,101 @@ int quantum_utils_find_small_factor(int n) {
     return 1;
 }
 
-int quantum_utils_shor_find_factor(QuantumState *state, int N) {
-    (void)state;  // Unused in simulation
+typedef struct {
+    unsigned long long base;
+    unsigned long long modulus;
+} ModularExponentContext;
+
+/* f(x) = a^x mod N, used as the order-finding oracle */
+static unsigned int modular_exponent_oracle(unsigned int x, void *context) {
+    const ModularExponentContext *ctx = context;
+    unsigned long long result = 1 % ctx->modulus;
+    unsigned long long base = ctx->base % ctx->modulus;
+    
+    while (x) {
+        if (x & 1) result = (result * base) % ctx->modulus;
+        base = (base * base) % ctx->modulus;
+        x >>= 1;
+    }
+    return (unsigned int)result;
+}
+
+static long long modular_power(long long a, int exponent, int N) {
+    long long result = 1;
+    for (int i = 0; i < exponent; i++) {
+        result = (result * a) % N;
+    }
+    return result;
+}
+
+/* Recover the order r from a phase estimate measured / 2^t via continued
+ * fractions. Only the convergent denominators and a few small multiples are
+ * tried, so a useless estimate gives 0 and the caller measures again. */
+static int period_from_measurement(int measured, int counting_qubits, int a, int N) {
+    /* Phase 0 says nothing about r */
+    if (measured == 0) return 0;
+    
+    int max_multiple = 1;
+    while ((1 << max_multiple) < N) max_multiple++;  /* ceil(log2 N) */
     
+    long long numerator = measured;
+    long long denominator = 1LL << counting_qubits;
+    long long h_prev = 1, h_prev2 = 0;  /* Convergent numerators */
+    long long k_prev = 0, k_prev2 = 1;  /* Convergent denominators */
+    
+    while (denominator != 0) {
+        long long term = numerator / denominator;
+        long long remainder = numerator % denominator;
+        
+        long long h = term * h_prev + h_prev2;
+        long long k = term * k_prev + k_prev2;
+        h_prev2 = h_prev; h_prev = h;
+        k_prev2 = k_prev; k_prev = k;
+        
+        if (k > N) break;
+        
+        /* The first convergent is always 0/1 and carries no information. A
+         * later denominator may be a divisor of r, so try small multiples. */
+        for (int m = 1; k > 1 && m <= max_multiple && m * k <= N; m++) {
+            if (modular_power(a, (int)(m * k), N) == 1) return (int)(m * k);
+        }
+        
+        numerator = denominator;
+        denominator = remainder;
+    }
+    return 0;
+}
+
+/* Order finding by phase estimation on the state: counting register on the
+ * low qubits, a^x mod N computed into the work register by one oracle pass */
+static int quantum_order_finding(QuantumState *state, int a, int N) {
+    int work_qubits = 0;
+    while ((1 << work_qubits) <= N) work_qubits++;
+    
+    int counting_qubits = state->num_qubits - work_qubits;
+    if (counting_qubits < work_qubits) return 0;
+    
+    ModularExponentContext context = {(unsigned long long)a, (unsigned long long)N};
+    QuantumOracle oracle = {0, counting_qubits, counting_qubits, work_qubits,
+                            modular_exponent_oracle, &context};
+    
+    for (int attempt = 0; attempt < 4; attempt++) {
+        quantum_state_initialise_zero(state);
+        for (int i = 0; i < counting_qubits; i++) {
+            gate_hadamard(state, i);
+        }
+        gate_oracle(state, &oracle);
+        gate_inverse_qft(state, 0, counting_qubits - 1);
+        
+        int measured = quantum_state_measure_all(state) & ((1 << counting_qubits) - 1);
+        int period = period_from_measurement(measured, counting_qubits, a, N);
+        printf("      Phase estimate: %d/%d → r=%d\n", measured, 1 << counting_qubits, period);
+        if (period > 0) return period;
+    }
+    return 0;
+}
+
+int quantum_utils_shor_find_factor(QuantumState *state, int N) {
     if (quantum_utils_is_prime(N)) return 1;
     
     int a = 2;
@@ -546,7 +633,12 @@ int quantum_utils_shor_find_factor(QuantumState *state, int N) {
     int gcd_check = quantum_utils_gcd(a, N);
     if (gcd_check > 1) return gcd_check;
     
-    int period = quantum_utils_find_period(a, N);
+    printf("       Quantum order finding...\n");
+    int period = state ? quantum_order_finding(state, a, N) : 0;
+    if (period == 0) {
+        printf("       Falling back to classical period search\n");
+        period = quantum_utils_find_period(a, N);
+    }
     printf("      Base: a=%d, Period: r=%d\n", a, period);
     
     if (period == 0 || period % 2 != 0) {
@@ -554,13 +646,7 @@ int quantum_utils_shor_find_factor(QuantumState *state, int N) {
         return 1;
     }
     
-    printf("       Quantum simulation...\n");
-    
-    int half_period = period / 2;
-    long long a_pow_half = 1;
-    for (int i = 0; i < half_period; i++) {
-        a_pow_half = (a_pow_half * a) % N;
-    }
+    long long a_pow_half = modular_power(a, period / 2, N);
     
     if (a_pow_half == N - 1) {
         printf("       Unlucky case\n");
@@ -691,33 +777,15 @@ void quantum_utils_controlled_phase(QuantumState *state, int control, int target
         control >= state->num_qubits || target >= state->num_qubits || 
         control == target) return;
     
-    int control_mask = 1 << control;
-    int target_mask = 1 << target;
-    Complex phase_factor = complex_from_polar(1.0, angle);
-    
-    for (int i = 0; i < state->num_states; i++) {
-        if ((i & control_mask) && (i & target_mask)) {
-            state->amplitudes[i] = complex_multiply(state->amplitudes[i], phase_factor);
-        }
-    }
+    gate_controlled_phase(state, control, target, angle);
 }
 
 void quantum_utils_simplified_qft(QuantumState *state) {
     if (!state) return;
     
-    int n = state->num_qubits;
-    
-    for (int i = 0; i < n; i++) {
-        gate_hadamard(state, i);
-        for (int j = i + 1; j < n; j++) {
-            double angle = M_PI / (1 << (j - i));
-            quantum_utils_controlled_phase(state, j, i, angle);
-        }
-    }
-    
-    for (int i = 0; i < n / 2; i++) {
-        gate_swap(state, i, n - 1 - i);
-    }
+    /* Same transform as the H / controlled-phase / swap circuit with qubit 0
+     * as the most significant bit, computed as a single FFT */
+    gate_qft_msb_first(state, 0, state->num_qubits - 1);
 }
 
 // =============================================================================
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+#include "quantum_program.h"
+#include "quantum_observable.h"
+#include "quantum_gradient.h"
+
+/**
+ * Adjoint gradient regression cases
+ * Each case compares quantum_gradient_adjoint with central finite
+ * differences of the expectation, where every shifted run binds the source
+ * circuit and applies its gates one by one, so neither fused programs nor
+ * the backward sweep are involved in the reference.
+ */
+#define GRADIENT_TOLERANCE 1e-6
+#define GRADIENT_STEP 1e-5
+
+static int failures = 0;
+
+/* Expectation of observable after the unfused circuit at values */
+static double reference_expectation(QuantumCircuit *circuit, const double *values,
+                                    const PauliObservable *observable, const QuantumState *initial) {
+    QuantumState *state = quantum_state_copy(initial);
+    quantum_circuit_bind_parameters(circuit, values);
+    for (int i = 0; i < circuit->num_gates; i++) quantum_circuit_apply_gate(&circuit->gates[i], state, NULL);
+    double expectation = quantum_observable_expectation(observable, state);
+    quantum_state_destroy(state);
+    return expectation;
+}
+
+static void check(const char *name, QuantumCircuit *circuit, const double *values,
+                  const PauliTerm *terms, int num_terms, const QuantumState *initial) {
+    int num_parameters = circuit->num_parameters;
+    PauliObservable *observable = quantum_observable_create(circuit->num_qubits, terms, num_terms);
+    QuantumProgram *program = quantum_program_compile(circuit);
+    double *gradients = malloc((size_t)num_parameters * sizeof(double));
+    double *shifted = malloc((size_t)num_parameters * sizeof(double));
+    double expectation = 0.0;
+
+    int passed = observable && program && gradients && shifted &&
+                 quantum_program_bind(program, values) &&
+                 quantum_gradient_adjoint(program, observable, initial, &expectation, gradients);
+
+    double value_error = 0.0, gradient_error = 0.0;
+    if (passed) {
+        value_error = fabs(expectation - reference_expectation(circuit, values, observable, initial));
+        for (int p = 0; p < num_parameters; p++) {
+            for (int q = 0; q < num_parameters; q++) shifted[q] = values[q];
+            shifted[p] = values[p] + GRADIENT_STEP;
+            double above = reference_expectation(circuit, shifted, observable, initial);
+            shifted[p] = values[p] - GRADIENT_STEP;
+            double below = reference_expectation(circuit, shifted, observable, initial);
+            gradient_error = fmax(gradient_error, fabs(gradients[p] - (above - below) / (2.0 * GRADIENT_STEP)));
+        }
+        passed = value_error < GRADIENT_TOLERANCE && gradient_error < GRADIENT_TOLERANCE;
+    }
+
+    printf("%s: %s (%d parameters, expectation error %.1e, gradient error %.1e)\n",
+           passed ? "PASS" : "FAIL", name, num_parameters, value_error, gradient_error);
+    failures += !passed;
+    free(gradients);
+    free(shifted);
+    quantum_program_destroy(program);
+    quantum_observable_destroy(observable);
+}
+
+/* Parameters named p0, p1, ... */
+static void add_parameters(QuantumCircuit *circuit, int count) {
+    for (int p = 0; p < count; p++) {
+        char name[MAX_PARAMETER_NAME];
+        snprintf(name, sizeof(name), "p%d", p);
+        quantum_circuit_add_parameter(circuit, name);
+    }
+}
+
+int main(void) {
+    srand(41);
+    double values[32];
+    for (int p = 0; p < 32; p++) values[p] = 2.0 * M_PI * rand() / (double)RAND_MAX - M_PI;
+
+    QuantumState *zero = quantum_state_create(4);
+    quantum_state_initialise_zero(zero);
+
+    /* Layered ansatz, one parameter per rotation */
+    QuantumCircuit *circuit = quantum_circuit_create(4, "layered ansatz");
+    add_parameters(circuit, 24);
+    for (int layer = 0; layer < 3; layer++) {
+        for (int q = 0; q < 4; q++) {
+            quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_Y, q, layer * 8 + 2 * q);
+            quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_Z, q, layer * 8 + 2 * q + 1);
+        }
+        for (int q = 0; q < 3; q++) quantum_circuit_add_cnot(circuit, q, q + 1);
+    }
+    PauliTerm ising[] = {
+        {0x0, 0x3, 1.0}, {0x0, 0x6, -0.5}, {0x0, 0xC, 0.75},
+        {0x1, 0x0, 0.3}, {0x4, 0x0, -0.2}, {0xA, 0xA, 0.4}
+    };
+    check("layered ansatz", circuit, values, ising, 6, zero);
+    quantum_circuit_destroy(circuit);
+
+    /* Shared parameters, phases and fused single-qubit runs around fixed gates */
+    circuit = quantum_circuit_create(4, "shared parameters");
+    add_parameters(circuit, 3);
+    for (int q = 0; q < 4; q++) quantum_circuit_add_hadamard(circuit, q);
+    for (int q = 0; q < 4; q++) quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_X, q, 0);
+    quantum_circuit_add_parameterised_gate(circuit, GATE_PHASE, 1, 1);
+    quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_Y, 1, 2);
+    quantum_circuit_add_rotation_z(circuit, 1, 0.4);
+    quantum_circuit_add_controlled_phase(circuit, 1, 3, 0.7);
+    quantum_circuit_add_cz(circuit, 0, 2);
+    quantum_circuit_add_qft(circuit, 0, 3);
+    quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_Z, 2, 1);
+    quantum_circuit_add_swap(circuit, 0, 3);
+    quantum_circuit_add_parameterised_gate(circuit, GATE_ROTATION_X, 3, 0);
+    PauliTerm mixed[] = {{0x5, 0x0, 0.9}, {0x2, 0x2, -1.1}, {0x0, 0x9, 0.6}, {0xF, 0x3, 0.25}};
+    check("shared parameters", circuit, values, mixed, 4, zero);
+
+    /* Same circuit from a random initial state */
+    QuantumState *initial = quantum_state_create(4);
+    for (int i = 0; i < initial->num_states; i++) {
+        initial->amplitudes[i] = complex_create(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+    }
+    quantum_state_normalise(initial);
+    check("random initial state", circuit, values, mixed, 4, initial);
+    quantum_circuit_destroy(circuit);
+
+    quantum_state_destroy(zero);
+    quantum_state_destroy(initial);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
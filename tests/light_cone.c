@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+#include "quantum_optimise.h"
+
+/**
+ * Light-cone regression cases
+ * Each case prunes and runs a small circuit and checks the observed qubit's
+ * probability of reading 1 against the full circuit's.
+ */
+static int failures = 0;
+
+/* P(qubit = 1) on the restricted state, 0 if the qubit was dropped */
+static double probability_one(const QuantumState *state, const QubitRestriction *restriction, int qubit) {
+    for (int i = 0; i < restriction->num_qubits; i++) {
+        if (restriction->qubits[i] == qubit) {
+            double marginal[2];
+            quantum_state_marginal(state, 1u << i, marginal);
+            return marginal[1];
+        }
+    }
+    return 0.0;
+}
+
+static void check(const char *name, const QuantumCircuit *circuit, int qubit,
+                  double expected, int expected_gates) {
+    QubitRestriction restriction;
+    LightConeStats stats;
+    QuantumState *state = quantum_optimise_run_light_cone(circuit, 1u << qubit, &restriction, &stats);
+    double p = state ? probability_one(state, &restriction, qubit) : -1.0;
+    int passed = state && fabs(p - expected) < 1e-12 && stats.gates_after == expected_gates;
+
+    printf("%s: %s (P(q%d=1) = %.6f, %d gates kept)\n", passed ? "PASS" : "FAIL", name, qubit, p, stats.gates_after);
+    failures += !passed;
+    quantum_state_destroy(state);
+}
+
+int main(void) {
+    /* A measured qubit that is not observed must not empty the light cone */
+    QuantumCircuit *circuit = quantum_circuit_create(3, "unobserved measurement");
+    quantum_circuit_add_pauli_x(circuit, 0);
+    quantum_circuit_add_hadamard(circuit, 2);
+    quantum_circuit_add_measure(circuit, 2);
+    check("unobserved measurement", circuit, 0, 1.0, 1);
+    quantum_circuit_destroy(circuit);
+
+    /* An observed qubit that is measured ignores gates after its measurement */
+    circuit = quantum_circuit_create(3, "observed measurement");
+    quantum_circuit_add_pauli_x(circuit, 1);
+    quantum_circuit_add_cnot(circuit, 1, 0);
+    quantum_circuit_add_measure(circuit, 0);
+    quantum_circuit_add_pauli_x(circuit, 0);
+    quantum_circuit_add_hadamard(circuit, 2);
+    check("observed measurement", circuit, 0, 1.0, 3);
+    quantum_circuit_destroy(circuit);
+
+    /* Unmeasured observed qubit entangled with a measured one keeps the link */
+    circuit = quantum_circuit_create(2, "entangled with measurement");
+    quantum_circuit_add_hadamard(circuit, 1);
+    quantum_circuit_add_cnot(circuit, 1, 0);
+    quantum_circuit_add_measure(circuit, 1);
+    check("entangled with measurement", circuit, 0, 0.5, 2);
+    quantum_circuit_destroy(circuit);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "quantum_state.h"
+#include "quantum_circuit.h"
+#include "quantum_optimise.h"
+
+/**
+ * Optimiser regression cases
+ * Each case runs a circuit before and after quantum_optimise_circuit from
+ * |0...0> and checks the final states agree up to a global phase. Random
+ * circuits are seeded with inverse pairs and rotation runs so every rule
+ * gets exercised.
+ */
+#define NUM_RANDOM_CIRCUITS 200
+
+static int failures = 0;
+
+static QuantumState* run(const QuantumCircuit *circuit) {
+    QuantumState *state = quantum_state_create(circuit->num_qubits);
+    if (!state) return NULL;
+    quantum_state_initialise_zero(state);
+    for (int i = 0; i < circuit->num_gates; i++) {
+        if (!quantum_circuit_apply_gate(&circuit->gates[i], state, NULL)) {
+            quantum_state_destroy(state);
+            return NULL;
+        }
+    }
+    return state;
+}
+
+/* |<a|b>|, which is 1 when the states differ only by a global phase */
+static double overlap(const QuantumState *a, const QuantumState *b) {
+    double real = 0.0, imag = 0.0;
+    for (int i = 0; i < a->num_states; i++) {
+        Complex x = a->amplitudes[i], y = b->amplitudes[i];
+        real += x.real * y.real + x.imag * y.imag;
+        imag += x.real * y.imag - x.imag * y.real;
+    }
+    return sqrt(real * real + imag * imag);
+}
+
+/* Optimises a copy of circuit; min_removed < 0 skips the gate count check */
+static void check(const char *name, const QuantumCircuit *circuit, int min_removed, int verbose) {
+    /* Circuits are flat, so a struct copy duplicates one */
+    QuantumCircuit *optimised = quantum_circuit_create(circuit->num_qubits, circuit->description);
+    OptimiseStats stats = {0};
+    if (optimised) *optimised = *circuit;
+    int removed = optimised ? quantum_optimise_circuit(optimised, &stats) : -1;
+
+    QuantumState *expected = run(circuit);
+    QuantumState *actual = optimised ? run(optimised) : NULL;
+    double fidelity = expected && actual ? overlap(expected, actual) : 0.0;
+    int passed = fabs(fidelity - 1.0) < 1e-10 && removed >= 0 && removed >= min_removed &&
+                 stats.gates_after == optimised->num_gates;
+
+    if (verbose || !passed) {
+        printf("%s: %s (%d -> %d gates, |<a|b>| = %.12f)\n", passed ? "PASS" : "FAIL", name,
+               circuit->num_gates, optimised ? optimised->num_gates : -1, fidelity);
+    }
+    failures += !passed;
+    quantum_state_destroy(expected);
+    quantum_state_destroy(actual);
+    quantum_circuit_destroy(optimised);
+}
+
+static void add_random_gate(QuantumCircuit *circuit) {
+    int n = circuit->num_qubits;
+    int q = rand() % n, r = (q + 1 + rand() % (n - 1)) % n;
+    double angle = (rand() % 17 - 8) * M_PI / 8.0 + (rand() % 2 ? 0.0 : rand() / (double)RAND_MAX);
+
+    switch (rand() % 13) {
+        case 0: quantum_circuit_add_pauli_x(circuit, q); break;
+        case 1: quantum_circuit_add_pauli_y(circuit, q); break;
+        case 2: quantum_circuit_add_pauli_z(circuit, q); break;
+        case 3: quantum_circuit_add_hadamard(circuit, q); break;
+        case 4: quantum_circuit_add_phase(circuit, q, angle); break;
+        case 5: quantum_circuit_add_rotation_x(circuit, q, angle); break;
+        case 6: quantum_circuit_add_rotation_y(circuit, q, angle); break;
+        case 7: quantum_circuit_add_rotation_z(circuit, q, angle); break;
+        case 8: quantum_circuit_add_cnot(circuit, q, r); break;
+        case 9: quantum_circuit_add_cz(circuit, q, r); break;
+        case 10: quantum_circuit_add_swap(circuit, q, r); break;
+        case 11: quantum_circuit_add_controlled_phase(circuit, q, r, angle); break;
+        default: {
+            /* Repeat the previous gate, or its inverse for rotations */
+            if (circuit->num_gates == 0) break;
+            QuantumGate gate = circuit->gates[circuit->num_gates - 1];
+            if (gate.type == GATE_QFT || gate.type == GATE_IQFT) break;
+            double parameter = quantum_circuit_is_parameterisable(gate.type) && rand() % 2 ? -gate.parameter
+                                                                                          : gate.parameter;
+            quantum_circuit_add_gate(circuit, gate.type, gate.qubit1, gate.qubit2, parameter);
+            break;
+        }
+    }
+}
+
+int main(void) {
+    /* Self-inverse pairs, separated by a gate on another qubit */
+    QuantumCircuit *circuit = quantum_circuit_create(3, "inverse pairs");
+    quantum_circuit_add_hadamard(circuit, 0);
+    quantum_circuit_add_rotation_y(circuit, 1, 0.3);
+    quantum_circuit_add_hadamard(circuit, 0);
+    quantum_circuit_add_cnot(circuit, 1, 2);
+    quantum_circuit_add_cnot(circuit, 1, 2);
+    quantum_circuit_add_pauli_x(circuit, 2);
+    check("inverse pairs", circuit, 4, 1);
+    quantum_circuit_destroy(circuit);
+
+    /* Rotation runs fold into one gate, and a full turn drops out */
+    circuit = quantum_circuit_create(2, "rotation runs");
+    quantum_circuit_add_hadamard(circuit, 0);
+    quantum_circuit_add_hadamard(circuit, 1);
+    quantum_circuit_add_rotation_z(circuit, 0, 0.25);
+    quantum_circuit_add_rotation_z(circuit, 0, 0.5);
+    quantum_circuit_add_rotation_z(circuit, 0, -0.125);
+    quantum_circuit_add_phase(circuit, 1, M_PI);
+    quantum_circuit_add_phase(circuit, 1, M_PI);
+    quantum_circuit_add_rotation_x(circuit, 0, 0.0);
+    check("rotation runs", circuit, 4, 1);
+    quantum_circuit_destroy(circuit);
+
+    /* Gates on either side of a QFT and its inverse */
+    circuit = quantum_circuit_create(4, "qft pair");
+    quantum_circuit_add_hadamard(circuit, 0);
+    quantum_circuit_add_cnot(circuit, 0, 3);
+    quantum_circuit_add_qft(circuit, 0, 3);
+    quantum_circuit_add_inverse_qft(circuit, 0, 3);
+    quantum_circuit_add_rotation_y(circuit, 2, 1.1);
+    check("qft pair", circuit, 0, 1);
+    quantum_circuit_destroy(circuit);
+
+    /* Random circuits must keep their final state */
+    srand(2024);
+    int random_failures = failures;
+    for (int c = 0; c < NUM_RANDOM_CIRCUITS; c++) {
+        int n = 2 + c % 5;
+        circuit = quantum_circuit_create(n, "random");
+        int num_gates = 5 + rand() % 60;
+        for (int g = 0; g < num_gates; g++) add_random_gate(circuit);
+        if (c % 10 == 0) quantum_circuit_add_qft(circuit, 0, n - 1);
+        check("random circuit", circuit, -1, 0);
+        quantum_circuit_destroy(circuit);
+    }
+    printf("%s: %d random circuits\n", failures == random_failures ? "PASS" : "FAIL", NUM_RANDOM_CIRCUITS);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "quantum_state.h"
+#include "quantum_gates.h"
+
+/**
+ * QFT regression cases
+ * gate_qft, gate_inverse_qft and gate_qft_msb_first are checked against a
+ * naive DFT over the register, on random states. Small registers check
+ * every output for every qubit range; large ones sample outputs, since they
+ * are there to reach the parallel and cache-blocked transform paths.
+ */
+#define QFT_TOLERANCE 1e-10
+#define QFT_SAMPLES 64  /* Outputs checked on large registers */
+
+static int failures = 0;
+
+static void randomise(QuantumState *state) {
+    for (int i = 0; i < state->num_states; i++) {
+        state->amplitudes[i] = complex_create(rand() / (double)RAND_MAX - 0.5, rand() / (double)RAND_MAX - 0.5);
+    }
+    quantum_state_normalise(state);
+}
+
+static int reverse_bits(int value, int width) {
+    int reversed = 0;
+    for (int b = 0; b < width; b++) reversed |= ((value >> b) & 1) << (width - 1 - b);
+    return reversed;
+}
+
+/* Register value held by the first..last bits of index, first as the LSB
+ * unless msb_first */
+static int register_value(int index, int first, int width, int msb_first) {
+    int value = (index >> first) & ((1 << width) - 1);
+    return msb_first ? reverse_bits(value, width) : value;
+}
+
+/* Amplitude of output index under a naive DFT of the register; sign is +1
+ * for the QFT, -1 for its inverse */
+static Complex naive_dft(const QuantumState *input, int index, int first, int width, int sign, int msb_first) {
+    int size = 1 << width;
+    int k = register_value(index, first, width, msb_first);
+    int rest = index & ~((size - 1) << first);
+    double real = 0.0, imag = 0.0;
+
+    for (int j = 0; j < size; j++) {
+        int stored = msb_first ? reverse_bits(j, width) : j;
+        Complex a = input->amplitudes[rest | (stored << first)];
+        double angle = sign * 2.0 * M_PI * (double)((long long)j * k % size) / size;
+        real += a.real * cos(angle) - a.imag * sin(angle);
+        imag += a.real * sin(angle) + a.imag * cos(angle);
+    }
+    return complex_create(real / sqrt(size), imag / sqrt(size));
+}
+
+/* Largest error over all outputs, or QFT_SAMPLES random ones */
+static double transform_error(const QuantumState *input, const QuantumState *output, int first, int last,
+                              int sign, int msb_first, int sampled) {
+    int count = sampled ? QFT_SAMPLES : output->num_states;
+    double error = 0.0;
+    for (int s = 0; s < count; s++) {
+        int index = sampled ? rand() % output->num_states : s;
+        Complex expected = naive_dft(input, index, first, last - first + 1, sign, msb_first);
+        Complex actual = output->amplitudes[index];
+        error = fmax(error, fabs(expected.real - actual.real) + fabs(expected.imag - actual.imag));
+    }
+    return error;
+}
+
+static void check(int num_qubits, int first, int last, int verbose) {
+    int sampled = num_qubits > 10;
+    QuantumState *input = quantum_state_create(num_qubits);
+    randomise(input);
+    QuantumState *state = quantum_state_copy(input);
+
+    gate_qft(state, first, last);
+    double forward = transform_error(input, state, first, last, 1, 0, sampled);
+    gate_inverse_qft(state, first, last);
+    double round_trip = 0.0;
+    for (int i = 0; i < state->num_states; i++) {
+        round_trip = fmax(round_trip, fabs(state->amplitudes[i].real - input->amplitudes[i].real) +
+                                      fabs(state->amplitudes[i].imag - input->amplitudes[i].imag));
+    }
+    gate_inverse_qft(state, first, last);
+    double inverse = transform_error(input, state, first, last, -1, 0, sampled);
+
+    quantum_state_destroy(state);
+    state = quantum_state_copy(input);
+    gate_qft_msb_first(state, first, last);
+    double msb_first = transform_error(input, state, first, last, 1, 1, sampled);
+
+    int passed = forward < QFT_TOLERANCE && inverse < QFT_TOLERANCE &&
+                 round_trip < QFT_TOLERANCE && msb_first < QFT_TOLERANCE;
+    if (verbose || !passed) {
+        printf("%s: %d qubits, register %d..%d (qft %.1e, inverse %.1e, round trip %.1e, msb first %.1e)\n",
+               passed ? "PASS" : "FAIL", num_qubits, first, last, forward, inverse, round_trip, msb_first);
+    }
+    failures += !passed;
+    quantum_state_destroy(input);
+    quantum_state_destroy(state);
+}
+
+int main(void) {
+    srand(26);
+
+    /* Every register of every small state */
+    int small_failures = failures;
+    for (int n = 1; n <= 8; n++) {
+        for (int first = 0; first < n; first++) {
+            for (int last = first; last < n; last++) check(n, first, last, 0);
+        }
+    }
+    printf("%s: every register of 1 to 8 qubits\n", failures == small_failures ? "PASS" : "FAIL");
+
+    /* One register over the whole state, many small batches, and a few
+     * batches with inner strides, all above the parallel threshold */
+    check(16, 0, 15, 1);
+    check(16, 0, 4, 1);
+    check(16, 3, 12, 1);
+    check(16, 10, 15, 1);
+    check(17, 1, 16, 1);
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}